@@ -0,0 +1,68 @@
+#version 460
+#extension GL_EXT_buffer_reference : require
+
+layout (location = 0) out vec3 outColor;
+
+// VoxelFace records, see render_quad.h for the bit layout
+layout (buffer_reference, std430, buffer_reference_align = 8) readonly buffer FaceBuffer
+{
+    uvec2 faces[];
+};
+
+layout (push_constant) uniform Chunk
+{
+    vec3 worldPosition;
+    uint padding;
+    FaceBuffer faceBuffer;
+} chunk;
+
+layout (binding = 0) uniform GlobalData
+{
+    mat4 cameraPosition;
+} global;
+
+// QUAD_CORNERS from render_quad.h, four corners per side
+const uvec3 quadCorners[24] = uvec3[24](
+    uvec3(1, 0, 1), uvec3(1, 1, 1), uvec3(0, 1, 1), uvec3(0, 0, 1), // FRONT
+    uvec3(0, 0, 0), uvec3(0, 1, 0), uvec3(1, 1, 0), uvec3(1, 0, 0), // BACK
+    uvec3(0, 0, 0), uvec3(0, 0, 1), uvec3(0, 1, 1), uvec3(0, 1, 0), // LEFT
+    uvec3(1, 1, 0), uvec3(1, 1, 1), uvec3(1, 0, 1), uvec3(1, 0, 0), // RIGHT
+    uvec3(0, 1, 1), uvec3(1, 1, 1), uvec3(1, 1, 0), uvec3(0, 1, 0), // UP
+    uvec3(0, 0, 0), uvec3(1, 0, 0), uvec3(1, 0, 1), uvec3(0, 0, 1)  // DOWN
+);
+
+// normal axis per side pair
+const uint sideAxes[3] = uint[3](2u, 0u, 1u);
+
+const vec3 cornerColors[4] = vec3[4](
+    vec3(1.0f, 0.0f, 0.0f),
+    vec3(0.0f, 1.0f, 0.0f),
+    vec3(0.0f, 0.0f, 1.0f),
+    vec3(1.0f, 1.0f, 1.0f)
+);
+
+void main()
+{
+    // the shared quad index buffer makes face f vertices f * 4 to f * 4 + 3
+    uint faceIndex = uint(gl_VertexIndex) >> 2u;
+    uint corner = uint(gl_VertexIndex) & 3u;
+    uvec2 face = chunk.faceBuffer.faces[faceIndex];
+
+    uvec3 origin = uvec3(face.x & 63u, (face.x >> 6u) & 63u, (face.x >> 12u) & 63u);
+    uint width = ((face.x >> 18u) & 63u) + 1u;
+    uint height = ((face.x >> 24u) & 63u) + 1u;
+    uint side = face.y & 7u;
+    uint ao = (face.y >> (3u + corner * 2u)) & 3u;
+
+    // one voxel deep along the normal, width and height on the two axes after it
+    uint axis = sideAxes[side >> 1u];
+    uvec3 extent = uvec3(1u);
+    extent[(axis + 1u) % 3u] = width;
+    extent[(axis + 2u) % 3u] = height;
+
+    vec3 localPosition = vec3(origin + quadCorners[side * 4u + corner] * extent);
+    outColor = cornerColors[corner] * (1.0f - 0.2f * float(ao));
+
+    vec4 position = vec4(chunk.worldPosition + localPosition, 1.0f);
+    gl_Position = global.cameraPosition * position;
+}
\ No newline at end of file
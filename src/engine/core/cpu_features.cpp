@@ -0,0 +1,49 @@
+#include "cpu_features.h"
+
+#if defined(_MSC_VER) && defined(MOXEL_ARCH_X86)
+#include <intrin.h>
+#include <immintrin.h>
+#endif
+
+namespace Moxel
+{
+	static bool detect_avx2()
+	{
+#if defined(MOXEL_ARCH_X86) && (defined(__GNUC__) || defined(__clang__))
+		__builtin_cpu_init();
+
+		return __builtin_cpu_supports("avx2");
+#elif defined(MOXEL_ARCH_X86) && defined(_MSC_VER)
+		int info[4] = {};
+		__cpuid(info, 1);
+
+		// the os has to save ymm registers too
+		const bool osxsave = (info[2] & (1 << 27)) != 0;
+		if (osxsave == false || (_xgetbv(0) & 0x6) != 0x6)
+			return false;
+
+		__cpuidex(info, 7, 0);
+
+		return (info[1] & (1 << 5)) != 0;
+#else
+		return false;
+#endif
+	}
+
+	bool CpuFeatures::has_avx2()
+	{
+		static const bool supported = detect_avx2();
+
+		return supported;
+	}
+
+	bool CpuFeatures::has_neon()
+	{
+		// baseline on every 64-bit arm target
+#if defined(MOXEL_ARCH_ARM64)
+		return true;
+#else
+		return false;
+#endif
+	}
+}
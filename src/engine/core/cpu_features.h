@@ -0,0 +1,27 @@
+#pragma once
+
+// instruction sets a kernel may target, x86 code built for them needs MOXEL_TARGET_AVX2.
+// fma stays off, so gcc cannot fuse a kernel's multiplies and adds into differently rounded ones
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+	#define MOXEL_ARCH_X86 1
+	#if defined(__GNUC__) || defined(__clang__)
+		#define MOXEL_TARGET_AVX2 __attribute__((target("avx2")))
+	#else
+		#define MOXEL_TARGET_AVX2
+	#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+	#define MOXEL_ARCH_ARM64 1
+#endif
+
+namespace Moxel
+{
+	// runtime cpu detection, queried once and cached
+	class CpuFeatures
+	{
+	public:
+		CpuFeatures() = delete;
+
+		static bool has_avx2();
+		static bool has_neon();
+	};
+}
@@ -0,0 +1,118 @@
+#include "slab_pool.h"
+#include "logger/log.h"
+
+#include <algorithm>
+#include <new>
+
+namespace Moxel
+{
+	static std::mutex& get_registry_mutex()
+	{
+		static std::mutex mutex;
+		return mutex;
+	}
+
+	static std::vector<SlabPool*>& get_registry()
+	{
+		static std::vector<SlabPool*> pools;
+		return pools;
+	}
+
+	SlabPool::SlabPool(const char* name, const size_t blockSize, const size_t blockAlignment)
+	{
+		m_name = name;
+		m_blockSize = blockSize;
+		m_blockAlignment = std::max(blockAlignment, alignof(FreeBlock));
+
+		auto lock = std::unique_lock(get_registry_mutex());
+		get_registry().push_back(this);
+	}
+
+	SlabPool::~SlabPool()
+	{
+		{
+			auto lock = std::unique_lock(get_registry_mutex());
+			std::erase(get_registry(), this);
+		}
+
+		for (const auto slab: m_slabs)
+		{
+			::operator delete[](slab, std::align_val_t(m_blockAlignment));
+		}
+	}
+
+	void* SlabPool::allocate(const size_t size)
+	{
+		auto lock = std::unique_lock(m_mutex);
+
+		if (m_blockSize == 0)
+			m_blockSize = size;
+
+		LOG_ASSERT((size <= m_blockSize), "Allocation doesn't fit into slab pool block");
+
+		if (m_freeList == nullptr)
+			allocate_slab();
+
+		const auto block = m_freeList;
+		m_freeList = block->Next;
+
+		m_usedBlocks++;
+		m_highWaterMark = std::max(m_highWaterMark, m_usedBlocks);
+
+		return block;
+	}
+
+	void SlabPool::deallocate(void* block)
+	{
+		auto lock = std::unique_lock(m_mutex);
+
+		const auto freeBlock = static_cast<FreeBlock*>(block);
+		freeBlock->Next = m_freeList;
+		m_freeList = freeBlock;
+
+		m_usedBlocks--;
+	}
+
+	SlabPoolStats SlabPool::get_stats()
+	{
+		auto lock = std::unique_lock(m_mutex);
+
+		auto stats = SlabPoolStats();
+		stats.Name = m_name;
+		stats.BlockSize = m_blockSize;
+		stats.UsedBlocks = m_usedBlocks;
+		stats.HighWaterMark = m_highWaterMark;
+		stats.CapacityBlocks = m_slabs.size() * m_blocksPerSlab;
+
+		return stats;
+	}
+
+	void SlabPool::for_each_pool(const std::function<void(SlabPool&)>& function)
+	{
+		auto lock = std::unique_lock(get_registry_mutex());
+
+		for (const auto pool: get_registry())
+		{
+			function(*pool);
+		}
+	}
+
+	void SlabPool::allocate_slab()
+	{
+		// round blocks up so every one keeps the requested alignment
+		const size_t stride = (std::max(m_blockSize, sizeof(FreeBlock)) + m_blockAlignment - 1) / m_blockAlignment * m_blockAlignment;
+		if (m_blocksPerSlab == 0)
+			m_blocksPerSlab = std::max<size_t>(SLAB_BYTES / stride, 1);
+
+		const auto slab = static_cast<char*>(::operator new[](stride * m_blocksPerSlab, std::align_val_t(m_blockAlignment)));
+		m_slabs.push_back(slab);
+
+		// thread the new blocks into the free list
+		for (size_t i = 0; i < m_blocksPerSlab; ++i)
+		{
+			const auto block = reinterpret_cast<FreeBlock*>(slab + i * stride);
+			block->Next = m_freeList;
+			m_freeList = block;
+		}
+	}
+}
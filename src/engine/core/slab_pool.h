@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Moxel
+{
+	struct SlabPoolStats
+	{
+		std::string Name;
+		size_t BlockSize = 0;
+		size_t UsedBlocks = 0;
+		size_t HighWaterMark = 0;
+		size_t CapacityBlocks = 0;
+	};
+
+	// fixed size blocks carved out of large slabs and recycled through a free list,
+	// block size is taken from the first allocation when it isn't known up front
+	class SlabPool
+	{
+	public:
+		SlabPool(const char* name, size_t blockSize = 0, size_t blockAlignment = alignof(std::max_align_t));
+		~SlabPool();
+
+		SlabPool(const SlabPool&) = delete;
+		SlabPool& operator=(const SlabPool&) = delete;
+
+		void* allocate(size_t size);
+		void deallocate(void* block);
+
+		SlabPoolStats get_stats();
+
+		static void for_each_pool(const std::function<void(SlabPool&)>& function);
+	private:
+		struct FreeBlock
+		{
+			FreeBlock* Next;
+		};
+
+		void allocate_slab();
+
+		static constexpr size_t SLAB_BYTES = 1 << 20;
+
+		std::string m_name;
+		size_t m_blockSize = 0;
+		size_t m_blockAlignment = 0;
+		size_t m_blocksPerSlab = 0;
+
+		std::vector<void*> m_slabs;
+		FreeBlock* m_freeList = nullptr;
+
+		size_t m_usedBlocks = 0;
+		size_t m_highWaterMark = 0;
+
+		std::mutex m_mutex;
+	};
+
+	// std allocator over a slab pool, meant for std::allocate_shared where the
+	// rebound control block type is the only thing ever allocated
+	template<typename T>
+	class PoolAllocator
+	{
+	public:
+		using value_type = T;
+
+		PoolAllocator(SlabPool& pool)
+			: m_pool(&pool) { }
+
+		template<typename U>
+		PoolAllocator(const PoolAllocator<U>& other)
+			: m_pool(other.get_pool()) { }
+
+		T* allocate(const size_t count) { return static_cast<T*>(m_pool->allocate(count * sizeof(T))); }
+		void deallocate(T* block, size_t) { m_pool->deallocate(block); }
+
+		SlabPool* get_pool() const { return m_pool; }
+
+		template<typename U>
+		bool operator==(const PoolAllocator<U>& other) const { return m_pool == other.get_pool(); }
+	private:
+		SlabPool* m_pool = nullptr;
+	};
+}
@@ -12,18 +12,22 @@ namespace Moxel
 			{
 				while (true)
 				{
-					unique_lock lock(m_queueMutex);
-					m_notifier.wait(lock, [this]
+					function<void()> task;
 					{
-						return m_queue.empty() == false || m_isRunning == false;
-					});
+						unique_lock lock(m_queueMutex);
+						m_notifier.wait(lock, [this]
+						{
+							return m_queue.empty() == false || m_isRunning == false;
+						});
 
-					if (m_isRunning == false)
-						return;
+						if (m_isRunning == false)
+							return;
 
-					function<void()> task = std::move(m_queue.front());
-					m_queue.pop();
+						task = std::move(m_queue.front());
+						m_queue.pop();
+					}
 
+					// unlocked, so tasks run side by side and may enqueue more tasks
 					task();
 				}
 			});
@@ -32,7 +36,11 @@ namespace Moxel
 
 	ThreadPool::~ThreadPool()
 	{
-		m_isRunning = false;
+		{
+			// under the lock, so a worker between its predicate check and its wait cannot miss the wakeup
+			std::unique_lock lock(m_queueMutex);
+			m_isRunning = false;
+		}
 
 		m_notifier.notify_all();
 		for (auto& thread : m_threads)
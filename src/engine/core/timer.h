@@ -0,0 +1,25 @@
+#pragma once
+
+#include <chrono>
+
+namespace Moxel
+{
+	class Timer
+	{
+	public:
+		Timer() { reset(); }
+
+		void reset() { m_start = std::chrono::high_resolution_clock::now(); }
+
+		double elapsed_micros() const
+		{
+			const auto elapsed = std::chrono::high_resolution_clock::now() - m_start;
+
+			return std::chrono::duration<double, std::micro>(elapsed).count();
+		}
+
+		double elapsed_millis() const { return elapsed_micros() / 1000.0; }
+	private:
+		std::chrono::high_resolution_clock::time_point m_start;
+	};
+}
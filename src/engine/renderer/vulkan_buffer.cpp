@@ -4,82 +4,94 @@
 
 namespace Moxel
 {
-	//
-	// VulkanVertexArray
-	//
-
-	VulkanVertexArray::VulkanVertexArray(const std::vector<uint32_t>& indices, const std::vector<VoxelVertex>& vertices)
+	// creates a gpu only buffer filled through a staging buffer
+	static BufferAsset create_device_buffer(const void* data, const size_t size, const VkBufferUsageFlags usage)
 	{
 		auto& allocator = Application::get().get_allocator();
 
-		// vertex buffer
-		m_vertices = vertices;
-		const auto verticesSize = vertices.size() * sizeof(vertices[0]);
-		auto vertexBufferInfo = VkBufferCreateInfo();
-		vertexBufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
-		vertexBufferInfo.pNext = nullptr;
-		vertexBufferInfo.size = verticesSize;
-		vertexBufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
-
-		constexpr auto vertexMemoryUsage = VMA_MEMORY_USAGE_GPU_ONLY;
-
-		m_vertexBuffer = allocator.allocate_buffer(vertexBufferInfo, vertexMemoryUsage);
-
-		// index buffer
-		m_indices = indices.size();
-		const auto indicesSize = indices.size() * sizeof(indices[0]);
-		auto indexBufferInfo = VkBufferCreateInfo();
-		indexBufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
-		indexBufferInfo.pNext = nullptr;
-		indexBufferInfo.size = indicesSize;
-		indexBufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT;
-
-		constexpr auto indexMemoryUsage = VMA_MEMORY_USAGE_GPU_ONLY;
+		auto bufferInfo = VkBufferCreateInfo();
+		bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+		bufferInfo.pNext = nullptr;
+		bufferInfo.size = size;
+		bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT | usage;
 
-		m_indexBuffer = allocator.allocate_buffer(indexBufferInfo, indexMemoryUsage);
+		const auto buffer = allocator.allocate_buffer(bufferInfo, VMA_MEMORY_USAGE_GPU_ONLY);
 
-		// allocate vertex array data
 		auto stagingBufferInfo = VkBufferCreateInfo();
 		stagingBufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
 		stagingBufferInfo.pNext = nullptr;
-		stagingBufferInfo.size = verticesSize + indicesSize;
+		stagingBufferInfo.size = size;
 		stagingBufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
 
-		constexpr auto stagingMemoryUsage = VMA_MEMORY_USAGE_CPU_ONLY;
-
-		const auto stagingBuffer = allocator.allocate_buffer(stagingBufferInfo, stagingMemoryUsage);
-
-		// copy buffers
-		void* data = stagingBuffer.AllocationInfo.pMappedData;
-		memcpy(data, vertices.data(), verticesSize);
-		memcpy(static_cast<char*>(data) + verticesSize, indices.data(), indicesSize);
+		const auto stagingBuffer = allocator.allocate_buffer(stagingBufferInfo, VMA_MEMORY_USAGE_CPU_ONLY);
+		memcpy(stagingBuffer.AllocationInfo.pMappedData, data, size);
 
 		VulkanRenderer::immediate_submit([&](const VkCommandBuffer cmd)
 		{
-			auto vertexCopy = VkBufferCopy();
-			vertexCopy.dstOffset = 0;
-			vertexCopy.srcOffset = 0;
-			vertexCopy.size = verticesSize;
-			vkCmdCopyBuffer(cmd, stagingBuffer.Buffer, m_vertexBuffer.Buffer, 1, &vertexCopy);
-
-			auto indexCopy = VkBufferCopy();
-			indexCopy.dstOffset = 0;
-			indexCopy.srcOffset = verticesSize;
-			indexCopy.size = indicesSize;
-			vkCmdCopyBuffer(cmd, stagingBuffer.Buffer, m_indexBuffer.Buffer, 1, &indexCopy);
+			auto copy = VkBufferCopy();
+			copy.dstOffset = 0;
+			copy.srcOffset = 0;
+			copy.size = size;
+			vkCmdCopyBuffer(cmd, stagingBuffer.Buffer, buffer.Buffer, 1, &copy);
 		});
 
 		allocator.destroy_buffer(stagingBuffer);
+
+		return buffer;
+	}
+
+	//
+	// VulkanFaceBuffer
+	//
+
+	VulkanFaceBuffer::VulkanFaceBuffer(const std::vector<VoxelFace>& faces)
+	{
+		m_faceCount = faces.size();
+		m_buffer = create_device_buffer(faces.data(), faces.size() * sizeof(faces[0]), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT);
+
+		auto addressInfo = VkBufferDeviceAddressInfo();
+		addressInfo.sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO;
+		addressInfo.pNext = nullptr;
+		addressInfo.buffer = m_buffer.Buffer;
+
+		m_deviceAddress = vkGetBufferDeviceAddress(Application::get().get_context().get_logical_device(), &addressInfo);
 	}
 
-	VulkanVertexArray::~VulkanVertexArray()
+	VulkanFaceBuffer::~VulkanFaceBuffer()
 	{
-		VulkanRenderer::free_resource_submit([vertex = m_vertexBuffer, index = m_indexBuffer]()
+		VulkanRenderer::free_resource_submit([buffer = m_buffer]()
 		{
 			auto allocator = Application::get().get_allocator();
 
-			allocator.destroy_buffer(vertex);
-			allocator.destroy_buffer(index);
+			allocator.destroy_buffer(buffer);
+		});
+	}
+
+	//
+	// VulkanQuadIndexBuffer
+	//
+
+	VulkanQuadIndexBuffer::VulkanQuadIndexBuffer()
+	{
+		auto indices = std::vector<uint16_t>(MAX_QUADS * 6);
+		for (uint32_t quad = 0; quad < MAX_QUADS; ++quad)
+		{
+			for (int i = 0; i < 6; ++i)
+			{
+				indices[quad * 6 + i] = static_cast<uint16_t>(quad * 4 + QUAD_INDICES[i]);
+			}
+		}
+
+		m_buffer = create_device_buffer(indices.data(), indices.size() * sizeof(uint16_t), VK_BUFFER_USAGE_INDEX_BUFFER_BIT);
+	}
+
+	VulkanQuadIndexBuffer::~VulkanQuadIndexBuffer()
+	{
+		VulkanRenderer::free_resource_submit([buffer = m_buffer]()
+		{
+			auto allocator = Application::get().get_allocator();
+
+			allocator.destroy_buffer(buffer);
 		});
 	}
 
@@ -13,24 +13,40 @@ namespace Moxel
 		VmaAllocationInfo AllocationInfo = VmaAllocationInfo();
 	};
 
-	class VulkanVertexArray
+	// chunk mesh as packed faces in a storage buffer, the vertex shader reads
+	// them through the buffer device address and builds the quad corners itself
+	class VulkanFaceBuffer
 	{
 	public:
-		VulkanVertexArray() = default;
-		VulkanVertexArray(const std::vector<uint32_t>& indices, const std::vector<VoxelVertex>& vertices);
-		~VulkanVertexArray();
+		VulkanFaceBuffer() = default;
+		VulkanFaceBuffer(const std::vector<VoxelFace>& faces);
+		~VulkanFaceBuffer();
 
-		const std::vector<VoxelVertex>& get_vertices() { return m_vertices; }
-		size_t get_index_buffer_size() const { return m_indices; }
+		size_t get_face_count() const { return m_faceCount; }
+		VkDeviceAddress get_device_address() const { return m_deviceAddress; }
 
-		BufferAsset& get_vertex_buffer() { return m_vertexBuffer; }
-		BufferAsset& get_index_buffer() { return m_indexBuffer; }
+		BufferAsset& get_buffer() { return m_buffer; }
 	private:
-		std::vector<VoxelVertex> m_vertices;
-		size_t m_indices = 0;
+		size_t m_faceCount = 0;
+		VkDeviceAddress m_deviceAddress = 0;
 
-		BufferAsset m_vertexBuffer;
-		BufferAsset m_indexBuffer;
+		BufferAsset m_buffer;
+	};
+
+	// immutable 16 bit quad list indices shared by every chunk mesh, face f is vertices f * 4 to f * 4 + 3.
+	// meshes with more faces than it covers are drawn in batches offset by MAX_QUADS * 4 vertices
+	class VulkanQuadIndexBuffer
+	{
+	public:
+		static constexpr uint32_t MAX_QUADS = 65536 / 4;
+
+		VulkanQuadIndexBuffer();
+		~VulkanQuadIndexBuffer();
+
+		static constexpr VkIndexType get_index_type() { return VK_INDEX_TYPE_UINT16; }
+		BufferAsset& get_buffer() { return m_buffer; }
+	private:
+		BufferAsset m_buffer;
 	};
 
 	class VulkanBufferUniform
@@ -1,6 +1,5 @@
 #include "vulkan_pipeline.h"
 #include "vulkan.h"
-#include "scene/voxels/render_quad.h"
 #include "engine/application.h"
 
 #include <ranges>
@@ -102,30 +101,14 @@ namespace Moxel
 		auto result = vkCreatePipelineLayout(device, &graphicsInfo, nullptr, &m_layout);
 		VULKAN_CHECK(result);
 
-		// set vertex input info
-		auto bindingDescription = VkVertexInputBindingDescription();
-		bindingDescription.binding = 0;
-		bindingDescription.stride = sizeof(VoxelVertex);
-		bindingDescription.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
-
-		auto attributeDescriptions = std::vector<VkVertexInputAttributeDescription>(2);
-		attributeDescriptions[0].binding = 0;
-		attributeDescriptions[0].location = 0;
-		attributeDescriptions[0].format = VK_FORMAT_R32_UINT;
-		attributeDescriptions[0].offset = offsetof(VoxelVertex, Position);
-
-		attributeDescriptions[1].binding = 0;
-		attributeDescriptions[1].location = 1;
-		attributeDescriptions[1].format = VK_FORMAT_R32G32B32_SFLOAT;
-		attributeDescriptions[1].offset = offsetof(VoxelVertex, Color);
-
+		// no vertex input, chunk shaders pull their faces from storage buffers
 		auto vertexInputInfo = VkPipelineVertexInputStateCreateInfo();
 		vertexInputInfo.pNext = nullptr;
 		vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
-		vertexInputInfo.vertexBindingDescriptionCount = 1;
-		vertexInputInfo.pVertexBindingDescriptions = &bindingDescription;
-		vertexInputInfo.vertexAttributeDescriptionCount = attributeDescriptions.size();
-		vertexInputInfo.pVertexAttributeDescriptions = attributeDescriptions.data();
+		vertexInputInfo.vertexBindingDescriptionCount = 0;
+		vertexInputInfo.pVertexBindingDescriptions = nullptr;
+		vertexInputInfo.vertexAttributeDescriptionCount = 0;
+		vertexInputInfo.pVertexAttributeDescriptions = nullptr;
 
 		// set input assembly info
 		auto inputAssemblyInfo = VkPipelineInputAssemblyStateCreateInfo();
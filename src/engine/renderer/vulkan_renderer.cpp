@@ -5,6 +5,8 @@
 
 #include <backends/imgui_impl_vulkan.h>
 
+#include <algorithm>
+
 namespace Moxel
 {
 	VulkanRenderer::RenderData VulkanRenderer::s_renderData;
@@ -15,6 +17,31 @@ namespace Moxel
 		glm::mat4 CameraMatrix;
 	};
 
+	// matches the push constant block in chunk_faces.vert
+	struct ChunkPushData
+	{
+		glm::vec3 WorldPosition;
+		uint32_t Padding = 0;
+		VkDeviceAddress Faces = 0;
+	};
+
+	// faces of a side point away from the camera unless it is past the chunk's nearest face plane,
+	// the chunk bounds stand in for the planes so the test is conservative
+	static bool is_side_visible(const Side side, const glm::vec3& camera, const glm::vec3& min, const glm::vec3& max)
+	{
+		switch (side)
+		{
+			case Side::FRONT: return camera.z > min.z;
+			case Side::BACK: return camera.z < max.z;
+			case Side::LEFT: return camera.x < max.x;
+			case Side::RIGHT: return camera.x > min.x;
+			case Side::UP: return camera.y > min.y;
+			case Side::DOWN: return camera.y < max.y;
+		}
+
+		return true;
+	}
+
 	void VulkanRenderer::initialize(const VkExtent2D& windowSize)
 	{
 		// initialize renderer
@@ -48,7 +75,7 @@ namespace Moxel
 		}
 
 		const auto fragment = std::make_shared<VulkanShader>(RESOURCES_PATH "triangle.frag.spv", ShaderType::FRAGMENT);
-		const auto vertex = std::make_shared<VulkanShader>(RESOURCES_PATH "triangle_meshed.vert.spv", ShaderType::VERTEX);
+		const auto vertex = std::make_shared<VulkanShader>(RESOURCES_PATH "chunk_faces.vert.spv", ShaderType::VERTEX);
 
 		auto pushConstant = VkPushConstantRange();
 		pushConstant.offset = 0;
@@ -71,6 +98,9 @@ namespace Moxel
 		fragment->release();
 		s_renderData.ShaderLibrary.add(vertex);
 		vertex->release();
+
+		// chunk meshes are quad lists drawn through one shared index buffer
+		s_renderData.QuadIndices = std::make_unique<VulkanQuadIndexBuffer>();
 	}
 
 	void VulkanRenderer::immediate_submit(std::function<void(VkCommandBuffer freeBuffer)>&& function)
@@ -200,7 +230,7 @@ namespace Moxel
 		s_renderData.CurrentFrameIndex = (s_renderData.CurrentFrameIndex + 1) % s_renderData.Specs.FRAMES_IN_FLIGHT;
 	}
 
-	void VulkanRenderer::render_chunk(const ChunkPosition chunkPosition, const std::shared_ptr<ChunkMesh>& chunk, const glm::mat4& cameraMat)
+	uint32_t VulkanRenderer::render_chunk(const ChunkPosition chunkPosition, const std::shared_ptr<ChunkMesh>& chunk, const glm::mat4& cameraMat, const glm::vec3& cameraPosition)
 	{
 		const auto& buffer = s_renderData.BufferData.CommandBuffer;
 
@@ -212,20 +242,56 @@ namespace Moxel
 		// launch a draw command to draw vertices
 		vkCmdBindPipeline(buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, s_renderData.MeshedPipeline->get_pipeline());
 
-		// update per-vertex data
-		const glm::vec3 chunkWorld = glm::vec3(chunkPosition.X, chunkPosition.Y, chunkPosition.Z) * 16.0f; 
-		vkCmdPushConstants(buffer, s_renderData.MeshedPipeline->get_pipeline_layout(), VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(glm::vec3), &chunkWorld);
-
-		const auto& vertexArray = chunk->get_chunk_mesh();
-		VkBuffer vertexBuffer = vertexArray->get_vertex_buffer().Buffer;
-		constexpr VkDeviceSize offsets[] = { 0 };
+		// the vertex shader pulls faces from the mesh's storage buffer, no vertex buffers are bound
+		const auto& faceBuffer = chunk->get_chunk_mesh();
+		const auto chunkSize = static_cast<float>(chunk->get_chunk_size());
 
-		vkCmdBindVertexBuffers(buffer, 0, 1, &vertexBuffer, offsets);
-		vkCmdBindIndexBuffer(buffer, vertexArray->get_index_buffer().Buffer, 0, VK_INDEX_TYPE_UINT32);
+		auto pushData = ChunkPushData();
+		pushData.WorldPosition = glm::vec3(chunkPosition.X, chunkPosition.Y, chunkPosition.Z) * chunkSize;
+		pushData.Faces = faceBuffer->get_device_address();
+		vkCmdPushConstants(buffer, s_renderData.MeshedPipeline->get_pipeline_layout(), VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(ChunkPushData), &pushData);
 
 		const auto& set = s_renderData.GlobalSets[s_renderData.CurrentFrameIndex];
 		vkCmdBindDescriptorSets(buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, s_renderData.MeshedPipeline->get_pipeline_layout(), 0, 1, &set, 0, nullptr);
-		vkCmdDrawIndexed(buffer, vertexArray->get_index_buffer_size(), 1, 0, 0, 0);
+
+		// gl_VertexIndex / 4 picks the face, one draw per MAX_QUADS faces
+		vkCmdBindIndexBuffer(buffer, s_renderData.QuadIndices->get_buffer().Buffer, 0, VulkanQuadIndexBuffer::get_index_type());
+
+		const auto draw_faces = [&buffer](const uint32_t begin, const uint32_t end)
+		{
+			for (uint32_t first = begin; first < end; first += VulkanQuadIndexBuffer::MAX_QUADS)
+			{
+				const uint32_t faces = std::min(end - first, VulkanQuadIndexBuffer::MAX_QUADS);
+				vkCmdDrawIndexed(buffer, faces * 6, 1, 0, static_cast<int32_t>(first * 4), 0);
+			}
+		};
+
+		// every side is one range of the face buffer, adjacent visible sides share a draw
+		const auto& data = chunk->get_data();
+		const auto min = pushData.WorldPosition;
+		const auto max = min + chunkSize;
+
+		uint32_t drawnFaces = 0;
+		uint32_t begin = 0, end = 0;
+		for (int side = 0; side < 6; ++side)
+		{
+			if (is_side_visible(static_cast<Side>(side), cameraPosition, min, max) == false)
+				continue;
+
+			const auto sideBegin = data.get_side_begin(static_cast<Side>(side));
+			const auto sideEnd = data.get_side_end(static_cast<Side>(side));
+			drawnFaces += sideEnd - sideBegin;
+
+			if (sideBegin != end)
+			{
+				draw_faces(begin, end);
+				begin = sideBegin;
+			}
+			end = sideEnd;
+		}
+		draw_faces(begin, end);
+
+		return drawnFaces;
 	}
 
 	void VulkanRenderer::shutdown()
@@ -235,6 +301,7 @@ namespace Moxel
 
 		s_renderData.ShaderLibrary.destroy();
 		s_renderData.MeshedPipeline = nullptr;
+		s_renderData.QuadIndices = nullptr;
 
 		s_renderData.GlobalDescriptorPool = nullptr;
 		s_renderData.GlobalSets.clear();
@@ -26,7 +26,8 @@ namespace Moxel
 		static void prepare_frame();
 		static void end_frame();
 
-		static void render_chunk(const ChunkPosition chunkPosition, const std::shared_ptr<ChunkMesh>& chunk, const glm::mat4& cameraMat);
+		// draws only the face directions that can face the camera, returns the number of faces drawn
+		static uint32_t render_chunk(const ChunkPosition chunkPosition, const std::shared_ptr<ChunkMesh>& chunk, const glm::mat4& cameraMat, const glm::vec3& cameraPosition);
 
 		static VulkanSwapchain& get_swapchain() { return s_renderData.Swapchain; }
 		static VulkanCommandBuffer& get_command_pool() { return s_renderData.CommandPool; }
@@ -44,6 +45,7 @@ namespace Moxel
 			VulkanCommandBuffer CommandPool = VulkanCommandBuffer();
 
 			std::unique_ptr<VulkanGraphicsPipeline> MeshedPipeline;
+			std::unique_ptr<VulkanQuadIndexBuffer> QuadIndices;
 
 			std::unique_ptr<VulkanDescriptorPool> GlobalDescriptorPool;
 			std::vector<VkDescriptorSet> GlobalSets;
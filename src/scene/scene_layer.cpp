@@ -27,8 +27,7 @@ namespace Moxel
 			const auto& position = renderChunks.front().first;
 			const auto& chunk = renderChunks.front().second;
 
-			VulkanRenderer::render_chunk(position, chunk, m_camera.get_proj_view_mat());
-			m_verticesCount += chunk->get_chunk_mesh()->get_vertices().size();
+			m_facesCount += VulkanRenderer::render_chunk(position, chunk, m_camera.get_proj_view_mat(), cameraPosition);
 
 			renderChunks.pop();
 		}
@@ -42,12 +41,32 @@ namespace Moxel
 
 		ImGui::Text("Chunks Generated: %d", m_chunks.get_total_chunks_data_count());
 		ImGui::Text("Meshes Generated: %d", m_chunks.get_total_chunks_mesh_count());
-		ImGui::Text("Vertices Rendered: %d", m_verticesCount);
+		ImGui::Text("Faces Rendered: %d", m_facesCount);
+
+		const auto& cacheStats = m_chunks.get_cold_cache_stats();
+		ImGui::Text("Cold Cache: %zu chunks, %.2f MB, %zu hits / %zu misses", cacheStats.Entries, cacheStats.Bytes / 1048576.0, cacheStats.Hits, cacheStats.Misses);
+
+		const auto columnStats = m_chunks.get_column_cache_stats();
+		ImGui::Text("Column Cache: %zu columns, %zu hits / %zu misses", columnStats.Entries, columnStats.Hits, columnStats.Misses);
 		ImGui::Image(reinterpret_cast<ImTextureID>(m_image->get_image_id()), {400, 400});
 
+		SlabPool::for_each_pool([](SlabPool& pool)
+		{
+			const auto stats = pool.get_stats();
+			ImGui::Text("%s: %zu / %zu blocks, peak %zu", stats.Name.c_str(), stats.UsedBlocks, stats.CapacityBlocks, stats.HighWaterMark);
+		});
+
+		if (ImGui::Button("Run Chunk Benchmarks"))
+			m_benchmark.run_all();
+
+		for (const auto& result: m_benchmark.get_results())
+		{
+			ImGui::Text("%s: %.3f %s", result.Name.c_str(), result.Value, result.Unit.c_str());
+		}
+
 		ImGui::End();
 
-		m_verticesCount = 0;
+		m_facesCount = 0;
 	}
 
 	void SceneLayer::detach()
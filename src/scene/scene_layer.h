@@ -2,6 +2,7 @@
 
 #include "engine/core/layer/layer.h"
 #include "engine/renderer/vulkan_image.h"
+#include "voxels/chunk_benchmark.h"
 #include "voxels/chunk_generator.h"
 #include "voxels/render_camera.h"
 
@@ -23,7 +24,8 @@ namespace Moxel
 		std::shared_ptr<VulkanImage> m_image = nullptr;
 		RenderCamera m_camera;
 		ChunkBuilder m_chunks;
+		ChunkBenchmark m_benchmark;
 
-		int m_verticesCount = 0;
+		int m_facesCount = 0;
 	};
 }
\ No newline at end of file
@@ -1,6 +1,9 @@
 #include "chunk.h"
+#include "chunk_layout.h"
 
-#include <PerlinNoise.hpp>
+#include <algorithm>
+#include <bit>
+#include <cstring>
 
 #define GLM_ENABLE_EXPERIMENTAL
 #include <glm/glm.hpp>
@@ -9,45 +12,472 @@
 
 namespace Moxel
 {
-	Chunk::Chunk(const int size)
+	static SlabPool s_chunkPool = SlabPool("Chunks");
+	static SlabPool s_chunkMeshPool = SlabPool("Chunk meshes");
+	static SlabPool s_faceBufferPool = SlabPool("Chunk face buffers");
+
+	// terrain is solid where fractal noise over the world's voxels is above the threshold
+	static constexpr float TERRAIN_FREQUENCY = 0.01f;
+	static constexpr int TERRAIN_OCTAVES = 4;
+	static constexpr double TERRAIN_THRESHOLD = 0.5;
+
+	// uniform proofs split undecided boxes down to this many voxels per side before giving up
+	static constexpr int UNIFORM_PROOF_VOXELS = 2;
+
+	// a proof costs about as much as a few hundred samples, coarser lattices just sample
+	static constexpr int UNIFORM_PROOF_MIN_SAMPLES = 512;
+
+	// noise coordinates are scaled in float like the per voxel glm::vec3 they replace
+	static double to_noise(const int voxel)
 	{
-		m_blocks.resize(size);
+		return static_cast<double>(static_cast<float>(voxel) * TERRAIN_FREQUENCY);
 	}
 
-	Chunk::~Chunk()
+	static glm::dvec3 to_noise(const glm::ivec3& voxel)
 	{
-		m_blocks.clear();
+		return { to_noise(voxel.x), to_noise(voxel.y), to_noise(voxel.z) };
 	}
 
-	void Chunk::generate_data(const ChunkPosition position)
+	// whether the density over the inclusive voxel box stays on the solid or the air side of the threshold
+	static bool is_provably_uniform(const WorldNoise& noise, const glm::ivec3& min, const glm::ivec3& max, const bool solid)
 	{
-		const int chunkSize = cbrt(m_blocks.size());
+		const auto bounds = noise.octave3D_01_bounds(to_noise(min), to_noise(max), TERRAIN_OCTAVES);
+		if (solid ? bounds.Min > TERRAIN_THRESHOLD : bounds.Max <= TERRAIN_THRESHOLD)
+			return true;
+
+		// provably on the other side somewhere, or too small to split further
+		const auto extent = max - min + 1;
+		if ((solid ? bounds.Max <= TERRAIN_THRESHOLD : bounds.Min > TERRAIN_THRESHOLD) || std::max({ extent.x, extent.y, extent.z }) <= UNIFORM_PROOF_VOXELS)
+			return false;
 
-		// generate chunk data from perlin
-		const auto perlin = siv::PerlinNoise(123456u);
-		for (int z = 0; z < chunkSize; ++z)
+		// halves of every axis wider than one voxel
+		const auto middle = min + (max - min) / 2;
+		for (int i = 0; i < 8; ++i)
 		{
-			for (int y = 0; y < chunkSize; ++y)
+			const auto high = glm::ivec3(i & 1, (i >> 1) & 1, (i >> 2) & 1);
+			if ((high.x && extent.x == 1) || (high.y && extent.y == 1) || (high.z && extent.z == 1))
+				continue;
+
+			const auto childMin = glm::ivec3(high.x ? middle.x + 1 : min.x, high.y ? middle.y + 1 : min.y, high.z ? middle.z + 1 : min.z);
+			const auto childMax = glm::ivec3(high.x ? max.x : middle.x, high.y ? max.y : middle.y, high.z ? max.z : middle.z);
+			if (is_provably_uniform(noise, childMin, childMax, solid) == false)
+				return false;
+		}
+
+		return true;
+	}
+
+	Chunk::Chunk(const int chunkSize)
+	{
+		m_chunkSize = chunkSize;
+		m_summary.build_uniform(chunkSize, false);
+	}
+
+	std::shared_ptr<Chunk> Chunk::create(const int chunkSize)
+	{
+		return std::allocate_shared<Chunk>(PoolAllocator<Chunk>(s_chunkPool), chunkSize);
+	}
+
+	std::shared_ptr<Chunk> Chunk::clone() const
+	{
+		auto chunk = create(m_chunkSize);
+		chunk->m_uniformBlock = m_uniformBlock;
+		chunk->m_summary = m_summary;
+		chunk->m_generationStage = m_generationStage;
+		chunk->m_isProcessed = m_isProcessed;
+
+		if (m_blocks.has_value())
+			chunk->m_blocks.emplace(*m_blocks);
+
+		if (m_materials != nullptr)
+			chunk->m_materials = std::make_unique<ChunkPaletteStorage>(*m_materials);
+
+		return chunk;
+	}
+
+	void Chunk::set_block(const int index)
+	{
+		set_block_type(index, DEFAULT_BLOCK);
+	}
+
+	BlockId Chunk::get_block_type(const int index) const
+	{
+		if (m_blocks.has_value() == false)
+			return m_uniformBlock;
+
+		if (m_materials != nullptr)
+			return m_materials->get(index);
+
+		return m_blocks->get(index) ? DEFAULT_BLOCK : AIR_BLOCK;
+	}
+
+	void Chunk::set_block_type(const int index, const BlockId block)
+	{
+		if (m_blocks.has_value() == false)
+		{
+			if (block == m_uniformBlock)
+				return;
+
+			promote();
+		}
+
+		const bool wasSolid = m_blocks->get(index);
+		const bool isSolid = block != AIR_BLOCK;
+
+		if (m_materials == nullptr && block != AIR_BLOCK && block != DEFAULT_BLOCK)
+		{
+			// switch into palette mode, occupancy bits become the first palette indices
+			m_materials = std::make_unique<ChunkPaletteStorage>(ChunkPaletteStorage::from_occupancy(*m_blocks));
+		}
+
+		if (m_materials != nullptr)
+			m_materials->set(index, block);
+
+		if (isSolid)
+			m_blocks->set(index);
+		else
+			m_blocks->reset(index);
+
+		if (isSolid != wasSolid)
+		{
+			const int bitSize = std::countr_zero(static_cast<unsigned>(m_chunkSize));
+			const int mask = m_chunkSize - 1;
+
+			m_summary.update_voxel(*m_blocks, index & mask, (index >> bitSize) & mask, index >> (bitSize * 2), isSolid);
+		}
+	}
+
+	uint64_t Chunk::get_row(const int y, const int z) const
+	{
+		if (m_blocks.has_value())
+			return m_blocks->get_row(y, z);
+
+		if (m_uniformBlock == AIR_BLOCK)
+			return 0;
+
+		return m_chunkSize == 64 ? ~0ull : (1ull << m_chunkSize) - 1;
+	}
+
+	size_t Chunk::get_byte_size() const
+	{
+		size_t size = 0;
+		if (m_blocks.has_value())
+			size += m_blocks->get_byte_size();
+
+		if (m_materials != nullptr)
+			size += m_materials->get_byte_size();
+
+		return size;
+	}
+
+	void Chunk::generate_data(const ChunkPosition position, const WorldNoise& noise, const int sampleStep)
+	{
+		LOG_ASSERT((sampleStep > 0 && std::has_single_bit(static_cast<unsigned>(sampleStep)) && sampleStep <= m_chunkSize),
+			"Noise sample step must be a power of two no larger than the chunk");
+
+		dispatch_chunk_size(m_chunkSize, [this, position, &noise, sampleStep](auto layout)
+		{
+			generate_data<decltype(layout)::SIZE>(position, noise, sampleStep);
+		});
+	}
+
+	std::optional<BlockId> Chunk::find_uniform_terrain(const ChunkPosition position, const int chunkSize, const WorldNoise& noise, const int sampleStep)
+	{
+		// interpolated density stays within the lattice values, which reach one voxel past the chunk
+		const auto min = glm::ivec3(position.X, position.Y, position.Z) * chunkSize;
+		const auto max = min + (sampleStep > 1 ? chunkSize : chunkSize - 1);
+
+		static_assert(WorldNoise::BATCH_SIZE == 8, "Chunk corners must be one noise batch");
+
+		// the corners are one noise batch, chunks they already show crossing the threshold skip the bounds
+		double pointsX[WorldNoise::BATCH_SIZE], pointsY[WorldNoise::BATCH_SIZE], pointsZ[WorldNoise::BATCH_SIZE], density[WorldNoise::BATCH_SIZE];
+		for (int i = 0; i < 8; ++i)
+		{
+			pointsX[i] = to_noise(i & 1 ? max.x : min.x);
+			pointsY[i] = to_noise(i & 2 ? max.y : min.y);
+			pointsZ[i] = to_noise(i & 4 ? max.z : min.z);
+		}
+
+		noise.octave3D_01(pointsX, pointsY, pointsZ, density, TERRAIN_OCTAVES);
+
+		const bool solid = density[0] > TERRAIN_THRESHOLD;
+		for (int i = 1; i < 8; ++i)
+		{
+			if ((density[i] > TERRAIN_THRESHOLD) != solid)
+				return std::nullopt;
+		}
+
+		if (is_provably_uniform(noise, min, max, solid) == false)
+			return std::nullopt;
+
+		return solid ? DEFAULT_BLOCK : AIR_BLOCK;
+	}
+
+	template<int Size>
+	void Chunk::generate_data(const ChunkPosition position, const WorldNoise& noise, const int sampleStep)
+	{
+		// generate into a per-thread scratch first, so uniform chunks never allocate
+		thread_local auto scratch = ChunkBitStorage(Size);
+
+		constexpr int BATCH_SIZE = WorldNoise::BATCH_SIZE;
+		static_assert(Size % BATCH_SIZE == 0, "Rows must be whole noise batches");
+
+		// coarse lattice of (Size / sampleStep + 1)^3 noise values, the corners on the chunk's faces
+		// land on the same voxels as the neighbour's, so interpolated terrain has no seams
+		const int points = Size / sampleStep + 1;
+		const int sampleCount = sampleStep == 1 ? Size * Size * Size : points * points * points;
+
+		// chunks away from the surface never sample the noise per voxel
+		if (sampleCount >= UNIFORM_PROOF_MIN_SAMPLES)
+		{
+			if (const auto block = find_uniform_terrain(position, Size, noise, sampleStep); block.has_value())
+			{
+				m_blocks.reset();
+				m_materials = nullptr;
+				m_uniformBlock = *block;
+				m_summary.build_uniform(Size, *block != AIR_BLOCK);
+				return;
+			}
+		}
+
+		const auto origin = glm::i32vec3(position.X, position.Y, position.Z) * Size;
+
+		double pointsX[Size];
+		for (int x = 0; x < Size; ++x)
+		{
+			pointsX[x] = to_noise(origin.x + x);
+		}
+
+		thread_local auto lattice = std::vector<double>();
+		if (sampleStep > 1)
+		{
+			lattice.resize((sampleCount + BATCH_SIZE - 1) / BATCH_SIZE * BATCH_SIZE);
+
+			double batchX[BATCH_SIZE], batchY[BATCH_SIZE], batchZ[BATCH_SIZE];
+			for (int first = 0; first < sampleCount; first += BATCH_SIZE)
 			{
-				for (int x = 0; x < chunkSize; ++x)
+				for (int i = 0; i < BATCH_SIZE; ++i)
 				{
-					const auto offset = glm::vec3(position.X * chunkSize + x, position.Y * chunkSize + y, position.Z * chunkSize + z);
-					const double noise = perlin.octave3D_01(offset.x * 0.01f, offset.y * 0.01f, offset.z * 0.01f, 4);
+					// the last batch repeats the last point instead of reading past the lattice
+					const int point = std::min(first + i, sampleCount - 1);
+					batchX[i] = to_noise(origin.x + point % points * sampleStep);
+					batchY[i] = to_noise(origin.y + point / points % points * sampleStep);
+					batchZ[i] = to_noise(origin.z + point / (points * points) * sampleStep);
+				}
+
+				noise.octave3D_01(batchX, batchY, batchZ, lattice.data() + first, TERRAIN_OCTAVES);
+			}
+		}
+
+		const double cellScale = 1.0 / sampleStep;
+		const auto lerp = [](const double a, const double b, const double t) { return a + (b - a) * t; };
+
+		// generate chunk data from the world's noise, a whole X row at a time in batches
+		double pointsY[BATCH_SIZE], pointsZ[BATCH_SIZE], density[Size], columns[Size / 2 + 1];
+		for (int z = 0; z < Size; ++z)
+		{
+			std::fill_n(pointsZ, BATCH_SIZE, to_noise(origin.z + z));
+			for (int y = 0; y < Size; ++y)
+			{
+				if (sampleStep == 1)
+				{
+					std::fill_n(pointsY, BATCH_SIZE, to_noise(origin.y + y));
+					for (int x = 0; x < Size; x += BATCH_SIZE)
+					{
+						noise.octave3D_01(pointsX + x, pointsY, pointsZ, density + x, TERRAIN_OCTAVES);
+					}
+				}
+				else
+				{
+					// bilinear in y and z at every lattice column, then linear along the row
+					const double ty = (y % sampleStep) * cellScale;
+					const double tz = (z % sampleStep) * cellScale;
+					const double* corner00 = lattice.data() + (z / sampleStep * points + y / sampleStep) * points;
+					const double* corner10 = corner00 + points;
+					const double* corner01 = corner00 + points * points;
+					const double* corner11 = corner01 + points;
+
+					for (int column = 0; column < points; ++column)
+					{
+						columns[column] = lerp(lerp(corner00[column], corner10[column], ty), lerp(corner01[column], corner11[column], ty), tz);
+					}
+
+					for (int x = 0; x < Size; ++x)
+					{
+						const int column = x / sampleStep;
+						density[x] = lerp(columns[column], columns[column + 1], (x % sampleStep) * cellScale);
+					}
+				}
+
+				uint64_t row = 0;
+				for (int x = 0; x < Size; ++x)
+				{
+					if (density[x] > TERRAIN_THRESHOLD)
+						row |= 1ull << x;
+				}
+
+				scratch.set_row(y, z, row);
+			}
+		}
+
+		load_generated(scratch);
+	}
 
-					if (noise > 0.5f)
-						set_block(z * chunkSize * chunkSize + y * chunkSize + x);
+	void Chunk::generate_heights(const ChunkPosition position, const float* heights, const float minHeight, const float maxHeight)
+	{
+		const int bottom = position.Y * m_chunkSize;
+
+		// chunks wholly above or below the column's surface never look at the heights
+		if (static_cast<float>(bottom) >= maxHeight || static_cast<float>(bottom + m_chunkSize) <= minHeight)
+		{
+			m_blocks.reset();
+			m_materials = nullptr;
+			m_uniformBlock = static_cast<float>(bottom) >= maxHeight ? AIR_BLOCK : DEFAULT_BLOCK;
+			m_summary.build_uniform(m_chunkSize, m_uniformBlock != AIR_BLOCK);
+			return;
+		}
+
+		thread_local auto scratch = std::unique_ptr<ChunkBitStorage>();
+		if (scratch == nullptr || scratch->get_chunk_size() != m_chunkSize)
+			scratch = std::make_unique<ChunkBitStorage>(m_chunkSize);
+
+		for (int z = 0; z < m_chunkSize; ++z)
+		{
+			const float* row = heights + z * m_chunkSize;
+			for (int y = 0; y < m_chunkSize; ++y)
+			{
+				const auto worldY = static_cast<float>(bottom + y);
+
+				uint64_t bits = 0;
+				for (int x = 0; x < m_chunkSize; ++x)
+				{
+					if (worldY < row[x])
+						bits |= 1ull << x;
 				}
+
+				scratch->set_row(y, z, bits);
 			}
 		}
 
+		load_generated(*scratch);
+	}
+
+	void Chunk::load_generated(const ChunkBitStorage& blocks)
+	{
+		m_materials = nullptr;
+		if (blocks.is_empty() || blocks.is_full())
+		{
+			m_uniformBlock = blocks.is_empty() ? AIR_BLOCK : DEFAULT_BLOCK;
+			m_blocks.reset();
+			m_summary.build_uniform(m_chunkSize, m_uniformBlock != AIR_BLOCK);
+		}
+		else
+		{
+			m_blocks.emplace(blocks);
+			m_summary.build(*m_blocks);
+		}
+	}
+
+	void Chunk::load_uniform(const BlockId block)
+	{
+		m_blocks.reset();
+		m_materials = nullptr;
+		m_uniformBlock = block;
+		m_summary.build_uniform(m_chunkSize, block != AIR_BLOCK);
+
+		m_isProcessed = true;
+	}
+
+	void Chunk::load_occupancy(const uint64_t* words)
+	{
+		m_materials = nullptr;
+		m_blocks.emplace(m_chunkSize);
+		memcpy(m_blocks->get_words(), words, m_blocks->get_byte_size());
+		m_summary.build(*m_blocks);
+
 		m_isProcessed = true;
 	}
 
+	void Chunk::promote()
+	{
+		m_blocks.emplace(m_chunkSize);
+
+		if (m_uniformBlock == AIR_BLOCK)
+			return;
+
+		m_blocks->fill();
+
+		if (m_uniformBlock != DEFAULT_BLOCK)
+			m_materials = std::make_unique<ChunkPaletteStorage>(m_chunkSize * m_chunkSize * m_chunkSize, m_uniformBlock);
+	}
+
+	void Chunk::try_make_uniform()
+	{
+		if (m_blocks.has_value() == false)
+			return;
+
+		if (m_materials != nullptr)
+		{
+			m_materials->compact();
+			if (m_materials->get_palette().size() != 1)
+				return;
+
+			m_uniformBlock = m_materials->get_palette()[0];
+		}
+		else if (m_blocks->is_empty() || m_blocks->is_full())
+		{
+			m_uniformBlock = m_blocks->is_empty() ? AIR_BLOCK : DEFAULT_BLOCK;
+		}
+		else
+		{
+			return;
+		}
+
+		m_blocks.reset();
+		m_materials = nullptr;
+		m_summary.build_uniform(m_chunkSize, m_uniformBlock != AIR_BLOCK);
+	}
+
 	ChunkMesh::~ChunkMesh()
 	{
 		clear_mesh();
 	}
 
+	std::shared_ptr<ChunkMesh> ChunkMesh::create(ChunkMeshData data, const int chunkSize)
+	{
+		const auto vao = std::allocate_shared<VulkanFaceBuffer>(PoolAllocator<VulkanFaceBuffer>(s_faceBufferPool), data.Faces);
+
+		auto mesh = std::allocate_shared<ChunkMesh>(PoolAllocator<ChunkMesh>(s_chunkMeshPool), vao, chunkSize);
+		mesh->m_data = std::move(data);
+
+		return mesh;
+	}
+
+	const std::shared_ptr<ChunkMesh>& ChunkMesh::get_empty()
+	{
+		// every chunk without geometry shares this one
+		static const auto empty = std::make_shared<ChunkMesh>(nullptr);
+
+		return empty;
+	}
+
+	const std::shared_ptr<ChunkMesh>& ChunkMesh::get_empty(const int lod)
+	{
+		static const auto empties = []
+		{
+			auto meshes = std::array<std::shared_ptr<ChunkMesh>, MAX_LOD_LEVELS + 1>();
+			for (int level = 0; level <= MAX_LOD_LEVELS; ++level)
+			{
+				meshes[level] = std::make_shared<ChunkMesh>(nullptr);
+				meshes[level]->m_data.Lod = level;
+			}
+
+			return meshes;
+		}();
+
+		return empties[lod];
+	}
+
 	void ChunkMesh::clear_mesh()
 	{
 		if (m_chunkMesh == nullptr)
@@ -1,9 +1,14 @@
 #pragma once
 
+#include "chunk_mesh_data.h"
+#include "chunk_storage.h"
+#include "chunk_summary.h"
+#include "world_noise.h"
 #include "engine/renderer/vulkan_buffer.h"
 
 #include <vector>
 #include <memory>
+#include <optional>
 
 namespace Moxel
 {
@@ -18,38 +23,132 @@ namespace Moxel
 		{
 			return X == second.X && Y == second.Y && Z == second.Z;
 		}
+
+		// 21 bits per axis, covers +-1M chunks
+		uint64_t pack() const
+		{
+			return (static_cast<uint64_t>(X) & KEY_MASK) << 42 | (static_cast<uint64_t>(Y) & KEY_MASK) << 21 | (static_cast<uint64_t>(Z) & KEY_MASK);
+		}
+
+		static ChunkPosition unpack(const uint64_t key)
+		{
+			return { unpack_axis(key >> 42), unpack_axis(key >> 21), unpack_axis(key) };
+		}
+
+		// splitmix64 finalizer, every input bit affects every output bit
+		static uint64_t mix(uint64_t key)
+		{
+			key ^= key >> 30;
+			key *= 0xBF58476D1CE4E5B9ull;
+			key ^= key >> 27;
+			key *= 0x94D049BB133111EBull;
+			key ^= key >> 31;
+
+			return key;
+		}
+	private:
+		static constexpr uint64_t KEY_MASK = (1ull << 21) - 1;
+
+		static int unpack_axis(const uint64_t bits)
+		{
+			// sign extend from 21 bits
+			return static_cast<int>(static_cast<int64_t>((bits & KEY_MASK) << 43) >> 43);
+		}
 	};
 
 	class Chunk
 	{
 	public:
-		Chunk(int size);
-		~Chunk();
+		Chunk(int chunkSize);
+		~Chunk() = default;
 
-		bool get_block(const int index) const { return m_blocks[index]; }
-		void set_block(const int index) { m_blocks[index] = true; }
+		static std::shared_ptr<Chunk> create(int chunkSize);
+		std::shared_ptr<Chunk> clone() const;
 
+		bool get_block(const int index) const { return m_blocks.has_value() ? m_blocks->get(index) : m_uniformBlock != AIR_BLOCK; }
+		void set_block(int index);
+
+		BlockId get_block_type(int index) const;
+		void set_block_type(int index, BlockId block);
+
+		uint64_t get_row(int y, int z) const;
+
+		// uniform chunks hold no voxel array until the first differing write
+		bool is_uniform() const { return m_blocks.has_value() == false; }
+		bool is_empty() const { return is_uniform() && m_uniformBlock == AIR_BLOCK; }
+		bool is_full() const { return is_uniform() && m_uniformBlock != AIR_BLOCK; }
+		BlockId get_uniform_block() const { return m_uniformBlock; }
+		void try_make_uniform();
+
+		const ChunkSummary& get_summary() const { return m_summary; }
+		const ChunkBitStorage* get_storage() const { return m_blocks.has_value() ? &*m_blocks : nullptr; }
+		const ChunkPaletteStorage* get_materials() const { return m_materials.get(); }
+		int get_chunk_size() const { return m_chunkSize; }
+		size_t get_byte_size() const;
+
+		// set once every generation pass ran, or when the chunk is loaded whole
 		bool is_processed() const { return m_isProcessed; }
+		void mark_processed() { m_isProcessed = true; }
+
+		// generation passes already applied, see world_generation.h
+		int get_generation_stage() const { return m_generationStage; }
+		void set_generation_stage(const int stage) { m_generationStage = stage; }
+
+		// the base density pass, leaves the chunk unprocessed for the passes after it.
+		// sampleStep > 1 evaluates the noise every sampleStep voxels and interpolates the density in between
+		void generate_data(ChunkPosition position, const WorldNoise& noise, int sampleStep = 1);
 
-		void generate_data(ChunkPosition position);
+		// the block of a chunk whose density provably stays on one side of the terrain threshold,
+		// from noise bounds instead of samples. nullopt when the bounds cannot decide
+		static std::optional<BlockId> find_uniform_terrain(ChunkPosition position, int chunkSize, const WorldNoise& noise, int sampleStep = 1);
+
+		// the base height pass, voxels below heights[z * chunkSize + x] in world voxels are solid.
+		// leaves the chunk unprocessed like generate_data
+		void generate_heights(ChunkPosition position, const float* heights, float minHeight, float maxHeight);
+		void load_uniform(BlockId block);
+		void load_occupancy(const uint64_t* words);
 	private:
-		std::vector<bool> m_blocks;
+		template<int Size>
+		void generate_data(ChunkPosition position, const WorldNoise& noise, int sampleStep);
+
+		// takes generated occupancy, falling back to a uniform chunk when it is all one block
+		void load_generated(const ChunkBitStorage& blocks);
+		void promote();
+
+		int m_chunkSize = 0;
+		BlockId m_uniformBlock = AIR_BLOCK;
+
+		std::optional<ChunkBitStorage> m_blocks; // kept inline, only the words come from a pool
+		std::unique_ptr<ChunkPaletteStorage> m_materials = nullptr; // created on first non default material
 
+		ChunkSummary m_summary;
+
+		int m_generationStage = 0;
 		bool m_isProcessed = false;
 	};
 
 	class ChunkMesh
 	{
 	public:
-		ChunkMesh(const std::shared_ptr<VulkanVertexArray>& mesh)
-			: m_chunkMesh(mesh) { }
+		ChunkMesh(const std::shared_ptr<VulkanFaceBuffer>& mesh, const int chunkSize = 0)
+			: m_chunkMesh(mesh), m_chunkSize(chunkSize) { }
 		~ChunkMesh();
 
+		static std::shared_ptr<ChunkMesh> create(ChunkMeshData data, int chunkSize);
+		// shared by chunks without geometry at any level, the overload only at the given one
+		static const std::shared_ptr<ChunkMesh>& get_empty();
+		static const std::shared_ptr<ChunkMesh>& get_empty(int lod);
+
 		void clear_mesh();
 
-		const std::shared_ptr<VulkanVertexArray>& get_chunk_mesh() { return m_chunkMesh; }
+		const std::shared_ptr<VulkanFaceBuffer>& get_chunk_mesh() { return m_chunkMesh; }
+		const ChunkMeshData& get_data() const { return m_data; }
+		int get_lod() const { return m_data.Lod; }
+		int get_chunk_size() const { return m_chunkSize; }
 	private:
-		std::shared_ptr<VulkanVertexArray> m_chunkMesh = nullptr;
+		std::shared_ptr<VulkanFaceBuffer> m_chunkMesh = nullptr;
+		ChunkMeshData m_data; // kept so edits can replace single sections
+		int m_chunkSize = 0; // face positions are local to a chunk of this size
 	};
 }
 
@@ -58,10 +157,6 @@ struct std::hash<Moxel::ChunkPosition>
 {
 	std::size_t operator()(const Moxel::ChunkPosition& key) const noexcept
 	{
-		const size_t hx = std::hash<int>()(key.X);
-		const size_t hy = std::hash<int>()(key.Y);
-		const size_t hz = std::hash<int>()(key.Z);
-
-		return hx ^	((hy << 1) >> 1) ^ (hz << 1);
+		return Moxel::ChunkPosition::mix(key.pack());
 	}
-};
\ No newline at end of file
+};
@@ -0,0 +1,1322 @@
+#include "chunk_benchmark.h"
+#include "chunk_face_masks.h"
+#include "chunk_hash_map.h"
+#include "chunk_lod.h"
+#include "chunk_mesher.h"
+#include "chunk_snapshot.h"
+#include "world_generation.h"
+#include "engine/core/timer.h"
+#include "engine/core/logger/log.h"
+
+#include <PerlinNoise.hpp>
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <random>
+#include <thread>
+#include <unordered_map>
+
+namespace Moxel
+{
+	using ChunkMap = std::unordered_map<ChunkPosition, std::shared_ptr<Chunk>>;
+
+	static constexpr int BENCHMARK_REPEATS = 8;
+	static constexpr int CHURN_STEPS = 4;
+	static constexpr int SIZE_VOLUME = 128; // voxels per axis meshed by every chunk size
+
+	// the std::hash<ChunkPosition> combine used before packed keys
+	struct LegacyChunkHash
+	{
+		std::size_t operator()(const ChunkPosition& key) const noexcept
+		{
+			const size_t hx = std::hash<int>()(key.X);
+			const size_t hy = std::hash<int>()(key.Y);
+			const size_t hz = std::hash<int>()(key.Z);
+
+			return hx ^ ((hy << 1) >> 1) ^ (hz << 1);
+		}
+	};
+
+	// mirrors the hash map lookup the mesher used before padded snapshots
+	static bool get_voxel_hashed(const ChunkMap& chunks, ChunkPosition position, const int x, const int y, const int z, const int chunkSize)
+	{
+		int actualX = x, actualY = y, actualZ = z;
+
+		if (x < 0 || x >= chunkSize)
+		{
+			actualX = x < 0 ? chunkSize - 1 : 0;
+			position.X += x < 0 ? -1 : 1;
+		}
+
+		if (y < 0 || y >= chunkSize)
+		{
+			actualY = y < 0 ? chunkSize - 1 : 0;
+			position.Y += y < 0 ? -1 : 1;
+		}
+
+		if (z < 0 || z >= chunkSize)
+		{
+			actualZ = z < 0 ? chunkSize - 1 : 0;
+			position.Z += z < 0 ? -1 : 1;
+		}
+
+		return chunks.at(position)->get_block(actualZ * chunkSize * chunkSize + actualY * chunkSize + actualX);
+	}
+
+	// straddles the origin, where the terrain surface is
+	static std::vector<ChunkPosition> get_surface_positions()
+	{
+		auto positions = std::vector<ChunkPosition>();
+		for (int z = -1; z <= 0; ++z)
+		{
+			for (int y = -1; y <= 0; ++y)
+			{
+				for (int x = -1; x <= 0; ++x)
+				{
+					positions.emplace_back(x, y, z);
+				}
+			}
+		}
+
+		return positions;
+	}
+
+	static ChunkMap generate_region(const int radius, const int chunkSize, const WorldNoise& noise)
+	{
+		auto chunks = ChunkMap();
+		for (int z = -radius; z <= radius; ++z)
+		{
+			for (int y = -radius; y <= radius; ++y)
+			{
+				for (int x = -radius; x <= radius; ++x)
+				{
+					const auto position = ChunkPosition(x, y, z);
+					const auto chunk = Chunk::create(chunkSize);
+					chunk->generate_data(position, noise);
+
+					chunks.emplace(position, chunk);
+				}
+			}
+		}
+
+		return chunks;
+	}
+
+	static ChunkNeighbors get_region_neighbors(const ChunkMap& chunks, const ChunkPosition& position)
+	{
+		auto neighbors = ChunkNeighbors();
+		neighbors[static_cast<int>(Side::FRONT)] = chunks.at(ChunkPosition(position.X, position.Y, position.Z + 1)).get();
+		neighbors[static_cast<int>(Side::BACK)] = chunks.at(ChunkPosition(position.X, position.Y, position.Z - 1)).get();
+		neighbors[static_cast<int>(Side::LEFT)] = chunks.at(ChunkPosition(position.X - 1, position.Y, position.Z)).get();
+		neighbors[static_cast<int>(Side::RIGHT)] = chunks.at(ChunkPosition(position.X + 1, position.Y, position.Z)).get();
+		neighbors[static_cast<int>(Side::UP)] = chunks.at(ChunkPosition(position.X, position.Y + 1, position.Z)).get();
+		neighbors[static_cast<int>(Side::DOWN)] = chunks.at(ChunkPosition(position.X, position.Y - 1, position.Z)).get();
+
+		return neighbors;
+	}
+
+	// voxel faces covered by a mesh
+	static size_t count_covered_faces(const ChunkMeshArena& mesh)
+	{
+		const auto* faces = mesh.get_faces();
+
+		size_t covered = 0;
+		for (size_t i = 0; i < mesh.get_face_count(); ++i)
+		{
+			covered += faces[i].get_width() * faces[i].get_height();
+		}
+
+		return covered;
+	}
+
+	// same faces in the same (side, section) ranges
+	static bool is_same_mesh(const ChunkMeshData& mesh, const ChunkMeshData& expected)
+	{
+		if (mesh.Offsets != expected.Offsets || mesh.Faces.size() != expected.Faces.size())
+			return false;
+
+		for (size_t i = 0; i < mesh.Faces.size(); ++i)
+		{
+			if (mesh.Faces[i].Position != expected.Faces[i].Position || mesh.Faces[i].Attributes != expected.Faces[i].Attributes)
+				return false;
+		}
+
+		return true;
+	}
+
+	// faces per (side, voxel) square a mesh covers, lod faces span whole cells in voxels
+	static std::vector<uint8_t> get_face_coverage(const ChunkMeshArena& mesh, const int chunkSize)
+	{
+		const int volume = chunkSize * chunkSize * chunkSize;
+		auto coverage = std::vector<uint8_t>(static_cast<size_t>(volume) * 6);
+
+		const auto* faces = mesh.get_faces();
+		for (size_t i = 0; i < mesh.get_face_count(); ++i)
+		{
+			const auto side = faces[i].get_normal();
+			const int axis = get_side_axis(side);
+			const auto origin = glm::ivec3(faces[i].get_origin());
+
+			for (uint32_t u = 0; u < faces[i].get_width(); ++u)
+			{
+				for (uint32_t v = 0; v < faces[i].get_height(); ++v)
+				{
+					auto voxel = origin;
+					voxel[(axis + 1) % 3] += static_cast<int>(u);
+					voxel[(axis + 2) % 3] += static_cast<int>(v);
+
+					coverage[static_cast<int>(side) * volume + (voxel.z * chunkSize + voxel.y) * chunkSize + voxel.x]++;
+				}
+			}
+		}
+
+		return coverage;
+	}
+
+	// the coverage a lod mesh must have, every voxel square of every visible cell face once
+	static std::vector<uint8_t> get_cell_coverage(const ChunkLodGrid& grid, const int chunkSize)
+	{
+		const int volume = chunkSize * chunkSize * chunkSize;
+		const int size = grid.get_size();
+		const int scale = grid.get_scale();
+		auto coverage = std::vector<uint8_t>(static_cast<size_t>(volume) * 6);
+
+		for (int sideIndex = 0; sideIndex < 6; ++sideIndex)
+		{
+			const auto side = static_cast<Side>(sideIndex);
+			const int axis = get_side_axis(side);
+			const bool isPositive = side == Side::FRONT || side == Side::RIGHT || side == Side::UP;
+
+			for (int z = 0; z < size; ++z)
+			{
+				for (int y = 0; y < size; ++y)
+				{
+					for (int x = 0; x < size; ++x)
+					{
+						auto facing = glm::ivec3(x, y, z);
+						facing[axis] += isPositive ? 1 : -1;
+						if (grid.get(x, y, z) == AIR_BLOCK || grid.get(facing.x, facing.y, facing.z) != AIR_BLOCK)
+							continue;
+
+						for (int u = 0; u < scale; ++u)
+						{
+							for (int v = 0; v < scale; ++v)
+							{
+								auto voxel = glm::ivec3(x, y, z) * scale;
+								voxel[axis] += isPositive ? scale - 1 : 0;
+								voxel[(axis + 1) % 3] += u;
+								voxel[(axis + 2) % 3] += v;
+
+								coverage[sideIndex * volume + (voxel.z * chunkSize + voxel.y) * chunkSize + voxel.x]++;
+							}
+						}
+					}
+				}
+			}
+		}
+
+		return coverage;
+	}
+
+	// Chunk::generate_data before the world noise, a fresh PerlinNoise and scalar octaves per voxel
+	static void generate_legacy(const ChunkPosition position, const int chunkSize, const uint32_t seed, uint64_t* rows)
+	{
+		const auto perlin = siv::PerlinNoise(seed);
+		const auto origin = glm::i32vec3(position.X, position.Y, position.Z) * chunkSize;
+		for (int z = 0; z < chunkSize; ++z)
+		{
+			for (int y = 0; y < chunkSize; ++y)
+			{
+				uint64_t row = 0;
+				for (int x = 0; x < chunkSize; ++x)
+				{
+					const auto offset = glm::vec3(origin.x + x, origin.y + y, origin.z + z);
+					const double noise = perlin.octave3D_01(offset.x * 0.01f, offset.y * 0.01f, offset.z * 0.01f, 4);
+
+					if (noise > 0.5f)
+						row |= 1ull << x;
+				}
+
+				rows[z * chunkSize + y] = row;
+			}
+		}
+	}
+
+	ChunkBenchmark::ChunkBenchmark(const ChunkWorldSpecs specs)
+		: m_specs(specs), m_noise(specs.Seed)
+	{
+	}
+
+	void ChunkBenchmark::run_all()
+	{
+		m_results.clear();
+
+		run_generation();
+		run_coarse_generation();
+		run_uniform_bounds();
+		run_generation_pipeline();
+		run_column_cache();
+		run_neighbor_lookup();
+		run_hash_maps();
+		run_meshers();
+		run_section_edits();
+		run_lod_meshers();
+		run_face_masks();
+		run_chunk_sizes();
+	}
+
+	// terrain generation throughput before and after the shared world noise,
+	// every kernel has to produce the occupancy of the per chunk PerlinNoise path
+	void ChunkBenchmark::run_generation()
+	{
+		const int chunkSize = m_specs.ChunkSize;
+		const int rowCount = chunkSize * chunkSize;
+
+		const auto positions = get_surface_positions();
+		const double chunkCount = static_cast<double>(positions.size());
+		auto expected = std::vector<uint64_t>(positions.size() * rowCount);
+
+		auto timer = Timer();
+		for (size_t i = 0; i < positions.size(); ++i)
+		{
+			generate_legacy(positions[i], chunkSize, m_specs.Seed, &expected[i * rowCount]);
+		}
+		add_result("Generation: perlin per chunk", chunkCount / (timer.elapsed_micros() * 1e-6), "chunks/s");
+
+		auto noise = WorldNoise(m_specs.Seed);
+		for (const auto kernel: { NoiseKernel::SCALAR, NoiseKernel::AVX2 })
+		{
+			if (WorldNoise::is_supported(kernel) == false)
+				continue;
+
+			noise.set_kernel(kernel);
+
+			auto chunks = std::vector<std::shared_ptr<Chunk>>();
+			for (size_t i = 0; i < positions.size(); ++i)
+			{
+				chunks.emplace_back(Chunk::create(chunkSize));
+			}
+
+			timer.reset();
+			for (size_t i = 0; i < positions.size(); ++i)
+			{
+				chunks[i]->generate_data(positions[i], noise);
+			}
+			add_result(std::string("Generation: world noise ") + WorldNoise::get_kernel_name(kernel), chunkCount / (timer.elapsed_micros() * 1e-6), "chunks/s");
+
+			int mismatchedRows = 0;
+			for (size_t i = 0; i < positions.size(); ++i)
+			{
+				for (int z = 0; z < chunkSize; ++z)
+				{
+					for (int y = 0; y < chunkSize; ++y)
+					{
+						mismatchedRows += chunks[i]->get_row(y, z) != expected[i * rowCount + z * chunkSize + y];
+					}
+				}
+			}
+
+			LOG_ASSERT((mismatchedRows == 0), "World noise terrain differs from per chunk perlin");
+		}
+	}
+
+	// columns of chunks through the surface, the ones the noise bounds prove uniform skip sampling,
+	// every chunk still has to match the per chunk PerlinNoise occupancy
+	void ChunkBenchmark::run_uniform_bounds()
+	{
+		const int chunkSize = m_specs.ChunkSize;
+		const int rowCount = chunkSize * chunkSize;
+
+		auto positions = std::vector<ChunkPosition>();
+		for (int z = -1; z <= 0; ++z)
+		{
+			for (int y = -6; y < 6; ++y)
+			{
+				for (int x = -1; x <= 0; ++x)
+				{
+					positions.emplace_back(x, y, z);
+				}
+			}
+		}
+
+		const double chunkCount = static_cast<double>(positions.size());
+
+		auto chunks = std::vector<std::shared_ptr<Chunk>>();
+		for (size_t i = 0; i < positions.size(); ++i)
+		{
+			chunks.emplace_back(Chunk::create(chunkSize));
+		}
+
+		auto timer = Timer();
+		for (size_t i = 0; i < positions.size(); ++i)
+		{
+			chunks[i]->generate_data(positions[i], m_noise);
+		}
+		add_result("Generation: bounded columns", chunkCount / (timer.elapsed_micros() * 1e-6), "chunks/s");
+
+		int provenChunks = 0;
+		timer.reset();
+		for (const auto position: positions)
+		{
+			provenChunks += Chunk::find_uniform_terrain(position, chunkSize, m_noise).has_value();
+		}
+		add_result("Generation: bounded columns proof", timer.elapsed_micros() / chunkCount, "us/chunk");
+
+		int uniformChunks = 0;
+		int mismatchedRows = 0;
+		auto expected = std::vector<uint64_t>(rowCount);
+		for (size_t i = 0; i < positions.size(); ++i)
+		{
+			uniformChunks += chunks[i]->is_uniform();
+
+			generate_legacy(positions[i], chunkSize, m_specs.Seed, expected.data());
+			for (int row = 0; row < rowCount; ++row)
+			{
+				mismatchedRows += chunks[i]->get_row(row % chunkSize, row / chunkSize) != expected[row];
+			}
+		}
+
+		add_result("Generation: bounded columns uniform", uniformChunks, "chunks");
+		add_result("Generation: bounded columns proven uniform", provenChunks, "chunks");
+		LOG_ASSERT((mismatchedRows == 0), "Noise bounds classified a chunk the samples disagree with");
+	}
+
+	// cost of every layered generation pass, run stage by stage over a region so each pass
+	// sees its neighbours after the pass before, chunks past the region's border read as air.
+	// a ChunkBuilder running the same passes through its scheduler has to end up with the same
+	// chunks and meshes, the region reaches far enough past them that its border changes neither
+	void ChunkBenchmark::run_generation_pipeline()
+	{
+		const int chunkSize = m_specs.ChunkSize;
+		const auto passes = get_layered_generation_passes();
+		auto columns = ColumnCache(0, chunkSize);
+		auto chunks = ChunkMap();
+
+		// meshed chunks read their neighbours one chunk further out, and the player steps one chunk down later
+		constexpr int renderDistance = 2;
+		const int checkedDistance = renderDistance + 2;
+		const int radius = checkedDistance + get_generation_reach(passes);
+		for (int z = -radius; z <= radius; ++z)
+		{
+			for (int y = -radius; y <= radius; ++y)
+			{
+				for (int x = -radius; x <= radius; ++x)
+				{
+					chunks.emplace(ChunkPosition(x, y, z), Chunk::create(chunkSize));
+				}
+			}
+		}
+
+		const double chunkCount = static_cast<double>(chunks.size());
+		double totalMicros = 0.0;
+		for (int pass = 0; pass < static_cast<int>(passes.size()); ++pass)
+		{
+			const int neighborRadius = passes[pass].NeighborRadius;
+			auto staged = ChunkMap();
+
+			auto timer = Timer();
+			for (const auto& [position, chunk]: chunks)
+			{
+				auto neighbors = GenerationNeighborhood(chunkSize, neighborRadius);
+				for (int z = -neighborRadius; z <= neighborRadius; ++z)
+				{
+					for (int y = -neighborRadius; y <= neighborRadius; ++y)
+					{
+						for (int x = -neighborRadius; x <= neighborRadius; ++x)
+						{
+							if (const auto neighbor = chunks.find(ChunkPosition(position.X + x, position.Y + y, position.Z + z)); neighbor != chunks.end())
+								neighbors.set(glm::ivec3(x, y, z), neighbor->second);
+						}
+					}
+				}
+
+				const auto result = chunk->clone();
+				apply_generation_pass(passes[pass], *result, position, neighbors, m_noise, columns, m_specs.NoiseSampleStep);
+				staged.emplace(position, result);
+			}
+
+			const double micros = timer.elapsed_micros();
+			totalMicros += micros;
+			add_result(std::string("Pipeline: ") + get_generation_pass_name(passes[pass].Type), micros / chunkCount, "us/chunk");
+
+			chunks.swap(staged);
+		}
+
+		add_result("Pipeline: layered passes", chunkCount / (totalMicros * 1e-6), "chunks/s");
+
+		auto specs = m_specs;
+		specs.RenderDistance = renderDistance;
+		specs.GenerationPasses = passes;
+		specs.LodDistances = {};
+
+		const auto playerPosition = glm::vec3(static_cast<float>(chunkSize / 2));
+		auto builder = ChunkBuilder(specs);
+		settle_builder(builder, playerPosition);
+
+		// processed chunks in the region are compared to the staged ones, except the edited ones
+		const auto compare_chunks = [&](const std::vector<ChunkPosition>& skipped, int& compared, int& mismatched)
+		{
+			builder.m_dataChunks.for_each([&](const ChunkPosition& position, const std::shared_ptr<Chunk>& chunk)
+			{
+				if (chunk->is_processed() == false || std::max({ abs(position.X), abs(position.Y), abs(position.Z) }) > checkedDistance)
+					return;
+
+				if (std::find(skipped.begin(), skipped.end(), position) != skipped.end())
+					return;
+
+				const auto& expected = *chunks.at(position);
+				for (int i = 0; i < chunkSize * chunkSize * chunkSize; ++i)
+				{
+					if (chunk->get_block_type(i) != expected.get_block_type(i))
+					{
+						mismatched++;
+						break;
+					}
+				}
+
+				compared++;
+			});
+		};
+
+		// enclosed chunks are dropped once meshed, so every chunk still held and every mesh is compared
+		auto lock = std::unique_lock(builder.m_worldMutex);
+		int comparedChunks = 0;
+		int mismatchedChunks = 0;
+		compare_chunks({}, comparedChunks, mismatchedChunks);
+
+		auto arena = ChunkMeshArena();
+		int comparedMeshes = 0;
+		int mismatchedMeshes = 0;
+		builder.m_meshChunks.for_each([&](const ChunkPosition& position, const std::shared_ptr<ChunkMesh>& mesh)
+		{
+			arena.clear();
+			mesh_chunk(specs.Meshing, *chunks.at(position), get_region_neighbors(chunks, position), arena);
+
+			auto expected = ChunkMeshData();
+			arena.write_mesh(expected, ChunkMeshData(), ALL_MESH_SECTIONS, get_mesh_section_count(chunkSize));
+
+			mismatchedMeshes += mesh == nullptr || is_same_mesh(mesh->get_data(), expected) == false;
+			comparedMeshes++;
+		});
+
+		add_result("Pipeline: scheduler chunks compared", comparedChunks, "chunks");
+		add_result("Pipeline: scheduler mismatched chunks", mismatchedChunks, "chunks");
+		add_result("Pipeline: scheduler meshes compared", comparedMeshes, "meshes");
+		add_result("Pipeline: scheduler mismatched meshes", mismatchedMeshes, "meshes");
+		LOG_ASSERT((comparedChunks > 0 && comparedMeshes > 0), "Chunk builder produced nothing to compare");
+		LOG_ASSERT((mismatchedChunks == 0 && mismatchedMeshes == 0), "Scheduled generation passes differ from running them stage by stage");
+		lock.unlock();
+
+		// the bottom of the lowest processed chunks is carved out, so the surface of the chunks below
+		// them would change if their passes read the edits instead of the staged neighbours
+		int surfaceDepth = 0;
+		for (const auto& pass: passes)
+		{
+			if (pass.Type == GenerationPassType::SURFACE)
+				surfaceDepth = pass.Depth;
+		}
+
+		const auto edited = std::vector<ChunkPosition>{ ChunkPosition(-1, -3, -1), ChunkPosition(0, -3, -1), ChunkPosition(-1, -3, 0), ChunkPosition(0, -3, 0) };
+		int failedEdits = 0;
+		for (const auto& position: edited)
+		{
+			for (int z = 0; z < chunkSize; ++z)
+			{
+				for (int y = 0; y < surfaceDepth; ++y)
+				{
+					for (int x = 0; x < chunkSize; ++x)
+					{
+						failedEdits += builder.set_block(glm::ivec3(position.X, position.Y, position.Z) * chunkSize + glm::ivec3(x, y, z), AIR_BLOCK) == false;
+					}
+				}
+			}
+		}
+
+		// far enough for the edited chunks to go to the cold cache and the partial ones below to be dropped,
+		// then back one chunk lower, so the chunks below the edits are generated next to restored ones
+		const int awayDistance = renderDistance * 4 + get_generation_reach(passes) * 2 + 1;
+		settle_builder(builder, playerPosition + glm::vec3(0.0f, static_cast<float>(awayDistance * chunkSize), 0.0f));
+		settle_builder(builder, playerPosition - glm::vec3(0.0f, static_cast<float>(chunkSize * 2), 0.0f));
+
+		lock.lock();
+		int comparedRestored = 0;
+		int mismatchedRestored = 0;
+		compare_chunks(edited, comparedRestored, mismatchedRestored);
+
+		add_result("Pipeline: cold cache restores", static_cast<double>(builder.get_cold_cache_stats().Hits), "chunks");
+		add_result("Pipeline: chunks next to edits compared", comparedRestored, "chunks");
+		add_result("Pipeline: chunks next to edits mismatched", mismatchedRestored, "chunks");
+		LOG_ASSERT((failedEdits == 0 && builder.get_cold_cache_stats().Hits > 0 && comparedRestored > 0), "Chunk builder never restored the edited chunks");
+		LOG_ASSERT((mismatchedRestored == 0), "Generation passes read edited or restored chunks instead of their staged neighbours");
+	}
+
+	// base height pass over a tall stack of chunks, with every chunk building its own 2d fields
+	// against the column cache sharing them down the column
+	void ChunkBenchmark::run_column_cache()
+	{
+		const int chunkSize = m_specs.ChunkSize;
+		const auto pass = get_height_generation_passes()[0];
+		const auto neighbors = GenerationNeighborhood(chunkSize, 0);
+
+		constexpr int columnRadius = 2;
+		constexpr int height = 16;
+
+		auto positions = std::vector<ChunkPosition>();
+		for (int z = -columnRadius; z < columnRadius; ++z)
+		{
+			for (int y = -height / 2; y < height / 2; ++y)
+			{
+				for (int x = -columnRadius; x < columnRadius; ++x)
+				{
+					positions.emplace_back(x, y, z);
+				}
+			}
+		}
+
+		const double chunkCount = static_cast<double>(positions.size());
+		auto expected = std::vector<std::shared_ptr<Chunk>>();
+		// 2 slots for the 4 columns a z row cycles through recycle a slot on every chunk
+		for (const size_t capacity: { size_t(0), size_t(2), size_t(1024) })
+		{
+			auto columns = ColumnCache(capacity, chunkSize);
+			auto chunks = std::vector<std::shared_ptr<Chunk>>();
+			chunks.reserve(positions.size());
+
+			auto timer = Timer();
+			for (const auto& position: positions)
+			{
+				chunks.push_back(Chunk::create(chunkSize));
+				apply_generation_pass(pass, *chunks.back(), position, neighbors, m_noise, columns, m_specs.NoiseSampleStep);
+			}
+
+			const std::string name = capacity == 0 ? "Columns: uncached" : capacity < 16 ? "Columns: evicting" : "Columns: cached";
+			add_result(name, chunkCount / (timer.elapsed_micros() * 1e-6), "chunks/s");
+			add_result(name + " field builds", columns.get_stats().Misses / chunkCount, "per chunk");
+
+			if (expected.empty())
+			{
+				expected = std::move(chunks);
+				continue;
+			}
+
+			int mismatchedRows = 0;
+			for (size_t i = 0; i < positions.size(); ++i)
+			{
+				for (int z = 0; z < chunkSize; ++z)
+				{
+					for (int y = 0; y < chunkSize; ++y)
+					{
+						mismatchedRows += chunks[i]->get_row(y, z) != expected[i]->get_row(y, z);
+					}
+				}
+			}
+
+			LOG_ASSERT((mismatchedRows == 0), "Cached column fields changed the terrain");
+		}
+
+		// a world that opts into height terrain builds each column's fields once for the whole stack
+		auto specs = m_specs;
+		specs.RenderDistance = 2;
+		specs.GenerationPasses = get_height_generation_passes();
+		specs.LodDistances = {};
+
+		auto builder = ChunkBuilder(specs);
+		settle_builder(builder, glm::vec3(static_cast<float>(chunkSize / 2)));
+
+		const auto stats = builder.get_column_cache_stats();
+		add_result("Columns: builder field builds", static_cast<double>(stats.Misses), "columns");
+		add_result("Columns: builder cache hits", static_cast<double>(stats.Hits), "chunks");
+		LOG_ASSERT((stats.Misses > 0 && stats.Hits > stats.Misses), "Chunk builder did not share column fields down its columns");
+	}
+
+	// noise on a lattice every few voxels with trilinear density in between, the error is the share
+	// of voxels whose occupancy differs from sampling the noise at every voxel
+	void ChunkBenchmark::run_coarse_generation()
+	{
+		const int chunkSize = m_specs.ChunkSize;
+		const auto positions = get_surface_positions();
+		const double chunkCount = static_cast<double>(positions.size());
+		const double voxelCount = chunkCount * chunkSize * chunkSize * chunkSize;
+
+		auto expected = std::vector<std::shared_ptr<Chunk>>();
+		for (const auto position: positions)
+		{
+			expected.emplace_back(Chunk::create(chunkSize));
+			expected.back()->generate_data(position, m_noise);
+		}
+
+		for (const int step: { 2, 4, 8 })
+		{
+			const std::string name = "Generation: noise every " + std::to_string(step) + " voxels";
+			const int points = chunkSize / step + 1;
+
+			auto chunks = std::vector<std::shared_ptr<Chunk>>();
+			for (size_t i = 0; i < positions.size(); ++i)
+			{
+				chunks.emplace_back(Chunk::create(chunkSize));
+			}
+
+			auto timer = Timer();
+			for (size_t i = 0; i < positions.size(); ++i)
+			{
+				chunks[i]->generate_data(positions[i], m_noise, step);
+			}
+			add_result(name, chunkCount / (timer.elapsed_micros() * 1e-6), "chunks/s");
+
+			int mismatchedVoxels = 0;
+			for (size_t i = 0; i < positions.size(); ++i)
+			{
+				for (int z = 0; z < chunkSize; ++z)
+				{
+					for (int y = 0; y < chunkSize; ++y)
+					{
+						mismatchedVoxels += std::popcount(chunks[i]->get_row(y, z) ^ expected[i]->get_row(y, z));
+					}
+				}
+			}
+
+			add_result(name + " evaluations", static_cast<double>(points * points * points), "per chunk");
+			add_result(name + " mismatched voxels", 100.0 * mismatchedVoxels / voxelCount, "%");
+		}
+	}
+
+	void ChunkBenchmark::run_neighbor_lookup()
+	{
+		const int chunkSize = m_specs.ChunkSize;
+		const auto chunks = generate_region(2, chunkSize, m_noise);
+
+		auto centers = std::vector<ChunkPosition>();
+		for (int z = -1; z <= 1; ++z)
+		{
+			for (int y = -1; y <= 1; ++y)
+			{
+				for (int x = -1; x <= 1; ++x)
+				{
+					centers.emplace_back(x, y, z);
+				}
+			}
+		}
+
+		const int totalChunks = static_cast<int>(centers.size()) * BENCHMARK_REPEATS;
+
+		// hashed get_voxel path
+		int hashedFaces = 0;
+		auto timer = Timer();
+		for (int repeat = 0; repeat < BENCHMARK_REPEATS; ++repeat)
+		{
+			for (const auto& position: centers)
+			{
+				const auto& chunk = chunks.at(position);
+				for (int z = 0; z < chunkSize; ++z)
+				{
+					for (int y = 0; y < chunkSize; ++y)
+					{
+						for (int x = 0; x < chunkSize; ++x)
+						{
+							if (chunk->get_block(z * chunkSize * chunkSize + y * chunkSize + x) == false)
+								continue;
+
+							hashedFaces += get_voxel_hashed(chunks, position, x - 1, y, z, chunkSize) == false;
+							hashedFaces += get_voxel_hashed(chunks, position, x + 1, y, z, chunkSize) == false;
+							hashedFaces += get_voxel_hashed(chunks, position, x, y - 1, z, chunkSize) == false;
+							hashedFaces += get_voxel_hashed(chunks, position, x, y + 1, z, chunkSize) == false;
+							hashedFaces += get_voxel_hashed(chunks, position, x, y, z - 1, chunkSize) == false;
+							hashedFaces += get_voxel_hashed(chunks, position, x, y, z + 1, chunkSize) == false;
+						}
+					}
+				}
+			}
+		}
+		add_result("Neighbours: hashed get_voxel", timer.elapsed_micros() / totalChunks, "us/chunk");
+
+		// padded snapshot path, snapshot build is part of the measurement
+		int snapshotFaces = 0;
+		auto snapshot = PaddedChunkSnapshot(chunkSize);
+		timer.reset();
+		for (int repeat = 0; repeat < BENCHMARK_REPEATS; ++repeat)
+		{
+			for (const auto& position: centers)
+			{
+				snapshot.build(*chunks.at(position), get_region_neighbors(chunks, position));
+
+				const uint8_t* voxels = snapshot.get_data();
+				const int strideY = snapshot.get_stride_y();
+				const int strideZ = snapshot.get_stride_z();
+				for (int z = 0; z < chunkSize; ++z)
+				{
+					for (int y = 0; y < chunkSize; ++y)
+					{
+						for (int x = 0; x < chunkSize; ++x)
+						{
+							const int index = snapshot.get_index(x, y, z);
+							if (voxels[index] == 0)
+								continue;
+
+							snapshotFaces += (voxels[index - 1] == 0) + (voxels[index + 1] == 0)
+								+ (voxels[index - strideY] == 0) + (voxels[index + strideY] == 0)
+								+ (voxels[index - strideZ] == 0) + (voxels[index + strideZ] == 0);
+						}
+					}
+				}
+			}
+		}
+		add_result("Neighbours: padded snapshot", timer.elapsed_micros() / totalChunks, "us/chunk");
+
+		LOG_ASSERT((hashedFaces == snapshotFaces), "Padded snapshot disagrees with hashed lookup");
+	}
+
+	void ChunkBenchmark::run_meshers()
+	{
+		const int chunkSize = m_specs.ChunkSize;
+		const auto chunks = generate_region(2, chunkSize, m_noise);
+
+		auto mesh = ChunkMeshArena();
+		size_t coveredFaces[2] = {};
+
+		for (const auto mode: { MeshingMode::PER_FACE, MeshingMode::GREEDY })
+		{
+			const auto name = mode == MeshingMode::GREEDY ? std::string("Mesher: greedy") : std::string("Mesher: per face");
+
+			size_t triangles = 0;
+			int meshedChunks = 0;
+			auto timer = Timer();
+			for (int repeat = 0; repeat < BENCHMARK_REPEATS; ++repeat)
+			{
+				triangles = 0;
+				meshedChunks = 0;
+
+				for (int z = -1; z <= 1; ++z)
+				{
+					for (int y = -1; y <= 1; ++y)
+					{
+						for (int x = -1; x <= 1; ++x)
+						{
+							const auto position = ChunkPosition(x, y, z);
+
+							mesh.clear();
+							mesh_chunk(mode, *chunks.at(position), get_region_neighbors(chunks, position), mesh);
+
+							triangles += mesh.get_face_count() * 2;
+							meshedChunks++;
+
+							if (repeat == 0)
+								coveredFaces[static_cast<int>(mode)] += count_covered_faces(mesh);
+						}
+					}
+				}
+			}
+
+			add_result(name, timer.elapsed_micros() / (meshedChunks * BENCHMARK_REPEATS), "us/chunk");
+			add_result(name + " triangles", static_cast<double>(triangles), "triangles");
+		}
+
+		LOG_ASSERT((coveredFaces[0] == coveredFaces[1]), "Greedy mesh covers different faces than per face mesh");
+	}
+
+	// edits a voxel in every mesh section and on every border of a chunk, the sections the builder
+	// patches have to match meshing the same edits on a separately generated region whole
+	void ChunkBenchmark::run_section_edits()
+	{
+		constexpr int MAX_EDIT_ATTEMPTS = 64;
+
+		auto specs = m_specs;
+		specs.RenderDistance = 2;
+		specs.NoiseSampleStep = 1;
+		specs.GenerationPasses = { GenerationPass() };
+		specs.LodDistances = {};
+
+		const int chunkSize = specs.ChunkSize;
+		const int last = chunkSize - 1;
+		const int middle = chunkSize / 2;
+		const auto playerPosition = glm::vec3(static_cast<float>(middle));
+
+		auto builder = ChunkBuilder(specs);
+		settle_builder(builder, playerPosition);
+
+		auto edits = std::vector<glm::ivec3>();
+		for (int y = 1; y < chunkSize; y += MESH_SECTION_DEPTH)
+		{
+			edits.emplace_back(middle - 3, y, middle + 2);
+		}
+
+		for (const auto& voxel: { glm::ivec3(0, middle, middle), glm::ivec3(last, middle, middle), glm::ivec3(middle, 0, middle),
+			glm::ivec3(middle, last, middle), glm::ivec3(middle, middle, 0), glm::ivec3(middle, middle, last) })
+		{
+			edits.push_back(voxel);
+		}
+
+		// chunk (0, 0, 0) starts at world voxel 0, so an edit is also its voxel in the chunk
+		const auto center = ChunkPosition(0, 0, 0);
+		const auto expectedChunks = generate_region(2, chunkSize, m_noise);
+
+		auto arena = ChunkMeshArena();
+		int failedEdits = 0;
+		int mismatchedMeshes = 0;
+		for (const auto& voxel: edits)
+		{
+			auto& chunk = *expectedChunks.at(center);
+			const int index = (voxel.z * chunkSize + voxel.y) * chunkSize + voxel.x;
+			const BlockId block = chunk.get_block_type(index) == AIR_BLOCK ? DEFAULT_BLOCK : AIR_BLOCK;
+			chunk.set_block_type(index, block);
+
+			// enclosed chunks are evicted once meshed, the edit waits for the cold cache to bring them back
+			bool isEdited = builder.set_block(voxel, block);
+			for (int attempt = 0; attempt < MAX_EDIT_ATTEMPTS && isEdited == false; ++attempt)
+			{
+				builder.update(playerPosition);
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+				isEdited = builder.set_block(voxel, block);
+			}
+
+			failedEdits += isEdited == false;
+			settle_builder(builder, playerPosition);
+
+			auto lock = std::unique_lock(builder.m_worldMutex);
+			for (const auto& position: {
+				center,
+				ChunkPosition(-1, 0, 0), ChunkPosition(1, 0, 0),
+				ChunkPosition(0, -1, 0), ChunkPosition(0, 1, 0),
+				ChunkPosition(0, 0, -1), ChunkPosition(0, 0, 1) })
+			{
+				arena.clear();
+				mesh_chunk(specs.Meshing, *expectedChunks.at(position), get_region_neighbors(expectedChunks, position), arena);
+
+				auto expected = ChunkMeshData();
+				arena.write_mesh(expected, ChunkMeshData(), ALL_MESH_SECTIONS, get_mesh_section_count(chunkSize));
+
+				const auto* mesh = builder.m_meshChunks.find(position);
+				mismatchedMeshes += mesh == nullptr || *mesh == nullptr || is_same_mesh((*mesh)->get_data(), expected) == false;
+			}
+		}
+
+		add_result("Edits: voxels edited", static_cast<double>(edits.size() - failedEdits), "voxels");
+		add_result("Edits: patched mesh mismatches", mismatchedMeshes, "meshes");
+		LOG_ASSERT((failedEdits == 0), "Edited chunk never got its data back");
+		LOG_ASSERT((mismatchedMeshes == 0), "Patched mesh sections differ from a full remesh");
+	}
+
+	// updates the builder until its queues stay drained, with every chunk around the player generated and meshed
+	void ChunkBenchmark::settle_builder(ChunkBuilder& builder, const glm::vec3 playerPosition)
+	{
+		constexpr int SETTLED_UPDATES = 16;
+		constexpr int MAX_UPDATES = 20000;
+
+		int settled = 0;
+		for (int update = 0; update < MAX_UPDATES && settled < SETTLED_UPDATES; ++update)
+		{
+			builder.update(playerPosition);
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+			auto& renderQueue = builder.get_render_queue();
+			while (renderQueue.empty() == false)
+			{
+				renderQueue.pop();
+			}
+
+			auto lock = std::unique_lock(builder.m_worldMutex);
+			bool isDirty = false;
+			builder.m_dirtySections.for_each([&isDirty](const ChunkPosition&, const uint32_t sections)
+			{
+				isDirty = isDirty || sections != 0;
+			});
+
+			const bool isIdle = builder.m_dataGenerationQueue.empty() && builder.m_runningPasses == 0 &&
+				builder.m_meshGenerationQueue.empty() && builder.m_requestedMeshes.empty() && isDirty == false;
+			settled = isIdle ? settled + 1 : 0;
+		}
+
+		LOG_ASSERT((settled == SETTLED_UPDATES), "Chunk builder did not settle");
+	}
+
+	void ChunkBenchmark::run_lod_meshers()
+	{
+		const int chunkSize = m_specs.ChunkSize;
+		const auto chunks = generate_region(2, chunkSize, m_noise);
+
+		auto mesh = ChunkMeshArena();
+		for (int lod = 1; lod <= MAX_LOD_LEVELS; ++lod)
+		{
+			const auto name = "Mesher: lod " + std::to_string(lod) + " (" + std::to_string(1 << lod) + "x)";
+
+			size_t triangles = 0;
+			int meshedChunks = 0;
+			auto timer = Timer();
+			for (int repeat = 0; repeat < BENCHMARK_REPEATS; ++repeat)
+			{
+				triangles = 0;
+				meshedChunks = 0;
+
+				for (int z = -1; z <= 1; ++z)
+				{
+					for (int y = -1; y <= 1; ++y)
+					{
+						for (int x = -1; x <= 1; ++x)
+						{
+							const auto position = ChunkPosition(x, y, z);
+
+							mesh.clear();
+							mesh_chunk_lod(*chunks.at(position), get_region_neighbors(chunks, position), lod, m_specs.LodDownsampling, mesh);
+
+							triangles += mesh.get_face_count() * 2;
+							meshedChunks++;
+						}
+					}
+				}
+			}
+
+			add_result(name, timer.elapsed_micros() / (meshedChunks * BENCHMARK_REPEATS), "us/chunk");
+			add_result(name + " triangles", static_cast<double>(triangles), "triangles");
+		}
+
+		// every chunk of the block gets a random level, 0 meshed greedy at full resolution. lod meshes have to
+		// cover the visible faces of their grid exactly, and where the two sides of a chunk border disagree
+		// on a voxel square being solid the solid side needs a face there, or a crack opens
+		constexpr int LOD_TRIALS = 4;
+		const int volume = chunkSize * chunkSize * chunkSize;
+		auto random = std::mt19937(7);
+		auto grid = ChunkLodGrid();
+
+		int mismatchedMeshes = 0;
+		int cracks = 0;
+		for (const auto rule: { LodRule::ANY_SOLID, LodRule::MAJORITY })
+		{
+			for (int trial = 0; trial < LOD_TRIALS; ++trial)
+			{
+				// solid voxels as the chunk's mesh sees them, and the faces covering them
+				auto solids = std::unordered_map<ChunkPosition, std::vector<uint8_t>>();
+				auto coverages = std::unordered_map<ChunkPosition, std::vector<uint8_t>>();
+				for (int z = -1; z <= 1; ++z)
+				{
+					for (int y = -1; y <= 1; ++y)
+					{
+						for (int x = -1; x <= 1; ++x)
+						{
+							const auto position = ChunkPosition(x, y, z);
+							const auto& chunk = *chunks.at(position);
+							const auto neighbors = get_region_neighbors(chunks, position);
+							const int lod = static_cast<int>(random() % (MAX_LOD_LEVELS + 1));
+
+							auto& solid = solids[position];
+							solid.resize(volume);
+
+							mesh.clear();
+							if (lod == 0)
+							{
+								mesh_chunk(MeshingMode::GREEDY, chunk, neighbors, mesh);
+								for (int i = 0; i < volume; ++i)
+								{
+									solid[i] = chunk.get_block(i);
+								}
+							}
+							else
+							{
+								mesh_chunk_lod(chunk, neighbors, lod, rule, mesh);
+								grid.build(chunk, neighbors, lod, rule);
+
+								for (int i = 0; i < volume; ++i)
+								{
+									const int cellX = (i % chunkSize) >> lod;
+									const int cellY = (i / chunkSize % chunkSize) >> lod;
+									const int cellZ = (i / (chunkSize * chunkSize)) >> lod;
+									solid[i] = grid.get(cellX, cellY, cellZ) != AIR_BLOCK;
+								}
+
+								mismatchedMeshes += get_face_coverage(mesh, chunkSize) != get_cell_coverage(grid, chunkSize);
+							}
+
+							coverages[position] = get_face_coverage(mesh, chunkSize);
+						}
+					}
+				}
+
+				for (const auto& [position, solid]: solids)
+				{
+					for (const auto side: { Side::RIGHT, Side::UP, Side::FRONT })
+					{
+						const int axis = get_side_axis(side);
+						auto next = glm::ivec3(position.X, position.Y, position.Z);
+						next[axis]++;
+
+						const auto other = solids.find(ChunkPosition(next.x, next.y, next.z));
+						if (other == solids.end())
+							continue;
+
+						const auto& coverage = coverages.at(position);
+						const auto& otherCoverage = coverages.at(other->first);
+						const int opposite = static_cast<int>(get_opposite_side(side));
+
+						for (int u = 0; u < chunkSize; ++u)
+						{
+							for (int v = 0; v < chunkSize; ++v)
+							{
+								auto voxel = glm::ivec3();
+								voxel[(axis + 1) % 3] = u;
+								voxel[(axis + 2) % 3] = v;
+
+								auto otherVoxel = voxel;
+								voxel[axis] = chunkSize - 1;
+								otherVoxel[axis] = 0;
+
+								const int index = (voxel.z * chunkSize + voxel.y) * chunkSize + voxel.x;
+								const int otherIndex = (otherVoxel.z * chunkSize + otherVoxel.y) * chunkSize + otherVoxel.x;
+
+								if (solid[index] && other->second[otherIndex] == 0 && coverage[static_cast<int>(side) * volume + index] == 0)
+									cracks++;
+								if (other->second[otherIndex] && solid[index] == 0 && otherCoverage[opposite * volume + otherIndex] == 0)
+									cracks++;
+							}
+						}
+					}
+				}
+			}
+		}
+
+		add_result("Mesher: lod mismatched meshes", mismatchedMeshes, "meshes");
+		add_result("Mesher: lod border cracks", cracks, "voxel faces");
+		LOG_ASSERT((mismatchedMeshes == 0), "Lod mesh faces differ from its downsampled grid");
+		LOG_ASSERT((cracks == 0), "Lod meshes leave cracks between chunks");
+	}
+
+	// every kernel must match the scalar path bit for bit, on noise and on random voxels
+	void ChunkBenchmark::run_face_masks()
+	{
+		const int chunkSize = m_specs.ChunkSize;
+		const int voxelCount = chunkSize * chunkSize * chunkSize;
+
+		auto chunks = generate_region(2, chunkSize, m_noise);
+
+		// replace one corner of the region with random fills of varying density
+		auto random = std::mt19937(1234);
+		for (int z = 0; z <= 2; ++z)
+		{
+			for (int y = 0; y <= 2; ++y)
+			{
+				for (int x = 0; x <= 2; ++x)
+				{
+					const auto chunk = Chunk::create(chunkSize);
+					const uint32_t density = random() % 100;
+					for (int i = 0; i < voxelCount; ++i)
+					{
+						if (random() % 100 < density)
+							chunk->set_block(i);
+					}
+
+					chunks[ChunkPosition(x, y, z)] = chunk;
+				}
+			}
+		}
+
+		auto centers = std::vector<ChunkPosition>();
+		for (int z = -1; z <= 1; ++z)
+		{
+			for (int y = -1; y <= 1; ++y)
+			{
+				for (int x = -1; x <= 1; ++x)
+				{
+					centers.emplace_back(x, y, z);
+				}
+			}
+		}
+
+		auto reference = ChunkFaceMasks(chunkSize);
+		auto masks = ChunkFaceMasks(chunkSize);
+		for (const auto kernel: { FaceMaskKernel::SCALAR, FaceMaskKernel::AVX2, FaceMaskKernel::NEON })
+		{
+			if (ChunkFaceMasks::is_supported(kernel) == false)
+				continue;
+
+			const auto name = std::string("Face masks: ") + ChunkFaceMasks::get_kernel_name(kernel);
+
+			int mismatches = 0;
+			for (const auto& position: centers)
+			{
+				const auto neighbors = get_region_neighbors(chunks, position);
+				reference.build(*chunks.at(position), neighbors, FaceMaskKernel::SCALAR);
+				masks.build(*chunks.at(position), neighbors, kernel);
+
+				const uint64_t* expected = reference.get_data();
+				const uint64_t* actual = masks.get_data();
+				for (size_t i = 0; i < masks.get_word_count(); ++i)
+				{
+					mismatches += expected[i] != actual[i];
+				}
+			}
+
+			auto timer = Timer();
+			for (int repeat = 0; repeat < BENCHMARK_REPEATS; ++repeat)
+			{
+				for (const auto& position: centers)
+				{
+					masks.build(*chunks.at(position), get_region_neighbors(chunks, position), kernel);
+				}
+			}
+
+			add_result(name, timer.elapsed_micros() / (centers.size() * BENCHMARK_REPEATS), "us/chunk");
+			add_result(name + " mismatched words", mismatches, "words");
+
+			LOG_ASSERT((mismatches == 0), "Face mask kernel disagrees with the scalar path");
+		}
+	}
+
+	void ChunkBenchmark::run_hash_maps()
+	{
+		for (const int renderDistance: { 5, 16, 32 })
+		{
+			const auto suffix = " R=" + std::to_string(renderDistance);
+
+			// the legacy hash collides so often at R=32 that one run stalls the UI for seconds
+			if (renderDistance < 32)
+				run_map_churn<std::unordered_map<ChunkPosition, int, LegacyChunkHash>>("Map churn: unordered_map legacy hash" + suffix, renderDistance);
+
+			run_map_churn<std::unordered_map<ChunkPosition, int>>("Map churn: unordered_map packed hash" + suffix, renderDistance);
+			run_map_churn<ChunkHashMap<int>>("Map churn: ChunkHashMap" + suffix, renderDistance);
+		}
+	}
+
+	// fills the box around the player, then walks it along X erasing the
+	// trailing slab, inserting the leading one and looking every chunk up
+	template<typename Map>
+	void ChunkBenchmark::run_map_churn(const std::string& name, const int renderDistance)
+	{
+		const int side = renderDistance * 2 + 1;
+
+		auto timer = Timer();
+		auto map = Map();
+		map.reserve(static_cast<size_t>(side) * side * side);
+
+		int64_t operations = 0;
+		for (int z = -renderDistance; z <= renderDistance; ++z)
+		{
+			for (int y = -renderDistance; y <= renderDistance; ++y)
+			{
+				for (int x = -renderDistance; x <= renderDistance; ++x)
+				{
+					map[ChunkPosition(x, y, z)] = x;
+					operations++;
+				}
+			}
+		}
+
+		int checksum = 0;
+		for (int step = 1; step <= CHURN_STEPS; ++step)
+		{
+			const int trailing = step - 1 - renderDistance;
+			const int leading = step + renderDistance;
+
+			for (int z = -renderDistance; z <= renderDistance; ++z)
+			{
+				for (int y = -renderDistance; y <= renderDistance; ++y)
+				{
+					map.erase(ChunkPosition(trailing, y, z));
+					map[ChunkPosition(leading, y, z)] = leading;
+					operations += 2;
+				}
+			}
+
+			for (int z = -renderDistance; z <= renderDistance; ++z)
+			{
+				for (int y = -renderDistance; y <= renderDistance; ++y)
+				{
+					for (int x = trailing + 1; x <= leading; ++x)
+					{
+						checksum += map.contains(ChunkPosition(x, y, z));
+						operations++;
+					}
+				}
+			}
+		}
+
+		add_result(name, timer.elapsed_micros() * 1000.0 / operations, "ns/op");
+		LOG_ASSERT((checksum == CHURN_STEPS * side * side * side), "Chunk map lost entries during churn");
+	}
+
+	void ChunkBenchmark::add_result(const std::string& name, const double value, const std::string& unit)
+	{
+		auto result = BenchmarkResult();
+		result.Name = name;
+		result.Value = value;
+		result.Unit = unit;
+
+		LOG_INFO("{0}: {1:.3f} {2}", result.Name, result.Value, result.Unit);
+		m_results.push_back(result);
+	}
+
+	void ChunkBenchmark::run_chunk_sizes()
+	{
+		run_chunk_size<16>();
+		run_chunk_size<32>();
+		run_chunk_size<64>();
+	}
+
+	// generates and meshes the same world volume cut into Size^3 chunks, fewer
+	// bigger chunks mean fewer draws but a higher cost per remesh
+	template<int Size>
+	void ChunkBenchmark::run_chunk_size()
+	{
+		constexpr int chunksPerAxis = SIZE_VOLUME / Size;
+		const auto prefix = "Chunk size " + std::to_string(Size) + ": ";
+
+		auto chunks = ChunkMap();
+		auto timer = Timer();
+		for (int z = 0; z < chunksPerAxis; ++z)
+		{
+			for (int y = 0; y < chunksPerAxis; ++y)
+			{
+				for (int x = 0; x < chunksPerAxis; ++x)
+				{
+					const auto position = ChunkPosition(x, y, z);
+					const auto chunk = Chunk::create(Size);
+					chunk->generate_data(position, m_noise);
+
+					chunks.emplace(position, chunk);
+				}
+			}
+		}
+
+		const int totalChunks = chunksPerAxis * chunksPerAxis * chunksPerAxis;
+		add_result(prefix + "generate", timer.elapsed_micros() / totalChunks, "us/chunk");
+
+		// the volume border faces open air
+		const auto air = Chunk(Size);
+		const auto find_neighbor = [&chunks, &air](const ChunkPosition& position)
+		{
+			const auto found = chunks.find(position);
+
+			return found != chunks.end() ? found->second.get() : &air;
+		};
+
+		auto mesh = ChunkMeshArena();
+		size_t totalFaces = 0;
+		int meshCount = 0;
+
+		timer.reset();
+		for (int repeat = 0; repeat < BENCHMARK_REPEATS; ++repeat)
+		{
+			totalFaces = 0;
+			meshCount = 0;
+
+			for (const auto& [position, chunk]: chunks)
+			{
+				auto neighbors = ChunkNeighbors();
+				neighbors[static_cast<int>(Side::FRONT)] = find_neighbor(ChunkPosition(position.X, position.Y, position.Z + 1));
+				neighbors[static_cast<int>(Side::BACK)] = find_neighbor(ChunkPosition(position.X, position.Y, position.Z - 1));
+				neighbors[static_cast<int>(Side::LEFT)] = find_neighbor(ChunkPosition(position.X - 1, position.Y, position.Z));
+				neighbors[static_cast<int>(Side::RIGHT)] = find_neighbor(ChunkPosition(position.X + 1, position.Y, position.Z));
+				neighbors[static_cast<int>(Side::UP)] = find_neighbor(ChunkPosition(position.X, position.Y + 1, position.Z));
+				neighbors[static_cast<int>(Side::DOWN)] = find_neighbor(ChunkPosition(position.X, position.Y - 1, position.Z));
+
+				mesh.clear();
+				mesh_chunk(m_specs.Meshing, *chunk, neighbors, mesh);
+
+				totalFaces += mesh.get_face_count();
+				meshCount += mesh.empty() == false;
+			}
+		}
+
+		add_result(prefix + "remesh", timer.elapsed_micros() / (totalChunks * BENCHMARK_REPEATS), "us/chunk");
+		add_result(prefix + "meshes", meshCount, "draws");
+		add_result(prefix + "faces", static_cast<double>(totalFaces), "faces");
+	}
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "chunk_generator.h"
+
+#include <string>
+#include <vector>
+
+namespace Moxel
+{
+	struct BenchmarkResult
+	{
+		std::string Name;
+		double Value = 0.0;
+		std::string Unit;
+	};
+
+	// in-engine microbenchmarks for the chunk pipeline, results go to log and stats window
+	class ChunkBenchmark
+	{
+	public:
+		ChunkBenchmark(ChunkWorldSpecs specs = ChunkWorldSpecs());
+
+		void run_all();
+
+		const std::vector<BenchmarkResult>& get_results() const { return m_results; }
+	private:
+		void run_generation();
+		void run_coarse_generation();
+		void run_uniform_bounds();
+		void run_generation_pipeline();
+		void run_column_cache();
+		void run_neighbor_lookup();
+		void run_hash_maps();
+		void run_meshers();
+		void run_section_edits();
+		void run_lod_meshers();
+		void run_face_masks();
+		void run_chunk_sizes();
+
+		template<int Size>
+		void run_chunk_size();
+
+		template<typename Map>
+		void run_map_churn(const std::string& name, int renderDistance);
+
+		void settle_builder(ChunkBuilder& builder, glm::vec3 playerPosition);
+
+		void add_result(const std::string& name, double value, const std::string& unit);
+
+		ChunkWorldSpecs m_specs;
+		WorldNoise m_noise;
+		std::vector<BenchmarkResult> m_results;
+	};
+}
@@ -0,0 +1,206 @@
+#include "chunk_cache.h"
+
+#include <algorithm>
+
+namespace Moxel
+{
+	ChunkCache::ChunkCache(const size_t byteBudget)
+	{
+		m_byteBudget = byteBudget;
+	}
+
+	void ChunkCache::store(const ChunkPosition position, const Chunk& chunk)
+	{
+		if (m_byteBudget == 0 || chunk.is_processed() == false)
+			return;
+
+		if (const auto entry = m_entries.find(position); entry != nullptr)
+			erase(*entry);
+
+		auto compressed = compress(position, chunk);
+		const auto size = compressed.get_byte_size();
+		if (size > m_byteBudget)
+			return;
+
+		// drop least recently stored chunks until the new one fits
+		while (m_stats.Bytes + size > m_byteBudget)
+		{
+			erase(std::prev(m_lru.end()));
+		}
+
+		m_lru.push_front(std::move(compressed));
+		m_entries[position] = m_lru.begin();
+
+		m_stats.Bytes += size;
+		m_stats.Entries++;
+	}
+
+	bool ChunkCache::restore(const ChunkPosition position, Chunk& chunk)
+	{
+		const auto entry = m_entries.find(position);
+		if (entry == nullptr)
+		{
+			m_stats.Misses++;
+			return false;
+		}
+
+		decompress(**entry, chunk);
+		erase(*entry);
+
+		m_stats.Hits++;
+		return true;
+	}
+
+	void ChunkCache::clear()
+	{
+		m_lru.clear();
+		m_entries.clear();
+
+		m_stats.Entries = 0;
+		m_stats.Bytes = 0;
+	}
+
+	ChunkCache::CompressedChunk ChunkCache::compress(const ChunkPosition position, const Chunk& chunk)
+	{
+		auto compressed = CompressedChunk();
+		compressed.Position = position;
+
+		if (chunk.is_uniform())
+		{
+			compressed.Type = Encoding::UNIFORM;
+			compressed.UniformBlock = chunk.get_uniform_block();
+
+			return compressed;
+		}
+
+		// run length encode every vertical column
+		const int chunkSize = chunk.get_chunk_size();
+		bool paletteOverflow = false;
+		for (int z = 0; z < chunkSize && paletteOverflow == false; ++z)
+		{
+			for (int x = 0; x < chunkSize && paletteOverflow == false; ++x)
+			{
+				int y = 0;
+				while (y < chunkSize)
+				{
+					const auto block = chunk.get_block_type(z * chunkSize * chunkSize + y * chunkSize + x);
+
+					int length = 1;
+					while (y + length < chunkSize && chunk.get_block_type(z * chunkSize * chunkSize + (y + length) * chunkSize + x) == block)
+					{
+						length++;
+					}
+
+					auto paletteIndex = std::find(compressed.Palette.begin(), compressed.Palette.end(), block) - compressed.Palette.begin();
+					if (paletteIndex == static_cast<int64_t>(compressed.Palette.size()))
+					{
+						if (compressed.Palette.size() == 256)
+						{
+							paletteOverflow = true;
+							break;
+						}
+
+						compressed.Palette.push_back(block);
+					}
+
+					compressed.Runs.push_back(static_cast<uint8_t>(paletteIndex));
+					compressed.Runs.push_back(static_cast<uint8_t>(length - 1));
+					y += length;
+				}
+			}
+		}
+
+		// plain occupancy is often smaller as raw bit planes than as runs
+		const auto& storage = *chunk.get_storage();
+		if (chunk.get_materials() == nullptr && (paletteOverflow || compressed.Runs.size() >= storage.get_byte_size()))
+		{
+			compressed.Type = Encoding::BIT_PLANES;
+			compressed.Palette.clear();
+			compressed.Runs.clear();
+			compressed.Words.assign(storage.get_words(), storage.get_words() + storage.get_word_count());
+
+			return compressed;
+		}
+
+		// byte sized run indices cannot name every block, so the voxels are kept as they are
+		if (paletteOverflow)
+		{
+			compressed.Type = Encoding::RAW_BLOCKS;
+			compressed.Palette.clear();
+			compressed.Runs.clear();
+
+			compressed.Blocks.resize(static_cast<size_t>(chunkSize) * chunkSize * chunkSize);
+			for (size_t i = 0; i < compressed.Blocks.size(); ++i)
+			{
+				compressed.Blocks[i] = chunk.get_block_type(static_cast<int>(i));
+			}
+
+			return compressed;
+		}
+
+		compressed.Type = Encoding::RLE_COLUMNS;
+		compressed.Runs.shrink_to_fit();
+		compressed.Palette.shrink_to_fit();
+
+		return compressed;
+	}
+
+	void ChunkCache::decompress(const CompressedChunk& compressed, Chunk& chunk)
+	{
+		switch (compressed.Type)
+		{
+			case Encoding::UNIFORM: chunk.load_uniform(compressed.UniformBlock); break;
+			case Encoding::BIT_PLANES: chunk.load_occupancy(compressed.Words.data()); break;
+			case Encoding::RLE_COLUMNS:
+			{
+				const int chunkSize = chunk.get_chunk_size();
+
+				size_t run = 0;
+				for (int z = 0; z < chunkSize; ++z)
+				{
+					for (int x = 0; x < chunkSize; ++x)
+					{
+						int y = 0;
+						while (y < chunkSize)
+						{
+							const auto block = compressed.Palette[compressed.Runs[run]];
+							const int length = compressed.Runs[run + 1] + 1;
+							run += 2;
+
+							for (int i = 0; i < length; ++i, ++y)
+							{
+								chunk.set_block_type(z * chunkSize * chunkSize + y * chunkSize + x, block);
+							}
+						}
+					}
+				}
+
+				chunk.try_make_uniform();
+				chunk.mark_processed();
+
+				break;
+			}
+			case Encoding::RAW_BLOCKS:
+			{
+				for (size_t i = 0; i < compressed.Blocks.size(); ++i)
+				{
+					chunk.set_block_type(static_cast<int>(i), compressed.Blocks[i]);
+				}
+
+				chunk.try_make_uniform();
+				chunk.mark_processed();
+
+				break;
+			}
+		}
+	}
+
+	void ChunkCache::erase(const std::list<CompressedChunk>::iterator entry)
+	{
+		m_stats.Bytes -= entry->get_byte_size();
+		m_stats.Entries--;
+
+		m_entries.erase(entry->Position);
+		m_lru.erase(entry);
+	}
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "chunk.h"
+#include "chunk_hash_map.h"
+
+#include <list>
+#include <vector>
+
+namespace Moxel
+{
+	struct ChunkCacheStats
+	{
+		size_t Entries = 0;
+		size_t Bytes = 0;
+		size_t Hits = 0;
+		size_t Misses = 0;
+	};
+
+	// cold tier for evicted chunk data, kept compressed under an LRU byte budget
+	// so revisited chunks are decompressed instead of regenerated from noise
+	class ChunkCache
+	{
+	public:
+		ChunkCache(size_t byteBudget);
+
+		void store(ChunkPosition position, const Chunk& chunk);
+		bool restore(ChunkPosition position, Chunk& chunk);
+
+		void clear();
+
+		const ChunkCacheStats& get_stats() const { return m_stats; }
+	private:
+		enum class Encoding
+		{
+			UNIFORM,
+			BIT_PLANES,
+			RLE_COLUMNS,
+			RAW_BLOCKS, // more blocks than a byte indexes, one id per voxel
+		};
+
+		struct CompressedChunk
+		{
+			ChunkPosition Position = ChunkPosition(0, 0, 0);
+			Encoding Type = Encoding::UNIFORM;
+			BlockId UniformBlock = AIR_BLOCK;
+
+			std::vector<BlockId> Palette;
+			std::vector<uint8_t> Runs; // (palette index, length) pairs per vertical column
+			std::vector<uint64_t> Words;
+			std::vector<BlockId> Blocks;
+
+			size_t get_byte_size() const { return sizeof(CompressedChunk) + (Palette.size() + Blocks.size()) * sizeof(BlockId) + Runs.size() + Words.size() * sizeof(uint64_t); }
+		};
+
+		static CompressedChunk compress(ChunkPosition position, const Chunk& chunk);
+		static void decompress(const CompressedChunk& compressed, Chunk& chunk);
+
+		void erase(std::list<CompressedChunk>::iterator entry);
+
+		size_t m_byteBudget = 0;
+
+		std::list<CompressedChunk> m_lru; // most recently stored first
+		ChunkHashMap<std::list<CompressedChunk>::iterator> m_entries;
+
+		ChunkCacheStats m_stats;
+	};
+}
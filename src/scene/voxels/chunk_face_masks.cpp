@@ -0,0 +1,200 @@
+#include "chunk_face_masks.h"
+#include "engine/core/cpu_features.h"
+#include "engine/core/logger/log.h"
+
+#if defined(MOXEL_ARCH_X86)
+#include <immintrin.h>
+#elif defined(MOXEL_ARCH_ARM64)
+#include <arm_neon.h>
+#endif
+
+namespace Moxel
+{
+	// one z slab, Rows starts at y = -1 and holds count + 2 words
+	struct FaceMaskSlab
+	{
+		const uint64_t* Rows;
+		const uint64_t* Back;
+		const uint64_t* Front;
+		const uint64_t* LeftEdge;
+		const uint64_t* RightEdge;
+
+		uint64_t* Masks[6]; // indexed by Side
+	};
+
+	static void compute_slab_scalar(const int count, const FaceMaskSlab& slab)
+	{
+		for (int y = 0; y < count; ++y)
+		{
+			const uint64_t row = slab.Rows[y + 1];
+
+			slab.Masks[static_cast<int>(Side::LEFT)][y] = row & ~((row << 1) | slab.LeftEdge[y]);
+			slab.Masks[static_cast<int>(Side::RIGHT)][y] = row & ~((row >> 1) | slab.RightEdge[y]);
+			slab.Masks[static_cast<int>(Side::DOWN)][y] = row & ~slab.Rows[y];
+			slab.Masks[static_cast<int>(Side::UP)][y] = row & ~slab.Rows[y + 2];
+			slab.Masks[static_cast<int>(Side::BACK)][y] = row & ~slab.Back[y];
+			slab.Masks[static_cast<int>(Side::FRONT)][y] = row & ~slab.Front[y];
+		}
+	}
+
+#if defined(MOXEL_ARCH_X86)
+	MOXEL_TARGET_AVX2 static inline __m256i load(const uint64_t* words) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(words)); }
+	MOXEL_TARGET_AVX2 static inline void store(uint64_t* words, const __m256i value) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(words), value); }
+
+	// four rows per step, count is a multiple of 4
+	MOXEL_TARGET_AVX2 static void compute_slab_avx2(const int count, const FaceMaskSlab& slab)
+	{
+		for (int y = 0; y < count; y += 4)
+		{
+			const __m256i row = load(slab.Rows + y + 1);
+			const __m256i left = _mm256_or_si256(_mm256_slli_epi64(row, 1), load(slab.LeftEdge + y));
+			const __m256i right = _mm256_or_si256(_mm256_srli_epi64(row, 1), load(slab.RightEdge + y));
+
+			store(slab.Masks[static_cast<int>(Side::LEFT)] + y, _mm256_andnot_si256(left, row));
+			store(slab.Masks[static_cast<int>(Side::RIGHT)] + y, _mm256_andnot_si256(right, row));
+			store(slab.Masks[static_cast<int>(Side::DOWN)] + y, _mm256_andnot_si256(load(slab.Rows + y), row));
+			store(slab.Masks[static_cast<int>(Side::UP)] + y, _mm256_andnot_si256(load(slab.Rows + y + 2), row));
+			store(slab.Masks[static_cast<int>(Side::BACK)] + y, _mm256_andnot_si256(load(slab.Back + y), row));
+			store(slab.Masks[static_cast<int>(Side::FRONT)] + y, _mm256_andnot_si256(load(slab.Front + y), row));
+		}
+	}
+#endif
+
+#if defined(MOXEL_ARCH_ARM64)
+	// two rows per step
+	static void compute_slab_neon(const int count, const FaceMaskSlab& slab)
+	{
+		for (int y = 0; y < count; y += 2)
+		{
+			const uint64x2_t row = vld1q_u64(slab.Rows + y + 1);
+			const uint64x2_t left = vorrq_u64(vshlq_n_u64(row, 1), vld1q_u64(slab.LeftEdge + y));
+			const uint64x2_t right = vorrq_u64(vshrq_n_u64(row, 1), vld1q_u64(slab.RightEdge + y));
+
+			vst1q_u64(slab.Masks[static_cast<int>(Side::LEFT)] + y, vbicq_u64(row, left));
+			vst1q_u64(slab.Masks[static_cast<int>(Side::RIGHT)] + y, vbicq_u64(row, right));
+			vst1q_u64(slab.Masks[static_cast<int>(Side::DOWN)] + y, vbicq_u64(row, vld1q_u64(slab.Rows + y)));
+			vst1q_u64(slab.Masks[static_cast<int>(Side::UP)] + y, vbicq_u64(row, vld1q_u64(slab.Rows + y + 2)));
+			vst1q_u64(slab.Masks[static_cast<int>(Side::BACK)] + y, vbicq_u64(row, vld1q_u64(slab.Back + y)));
+			vst1q_u64(slab.Masks[static_cast<int>(Side::FRONT)] + y, vbicq_u64(row, vld1q_u64(slab.Front + y)));
+		}
+	}
+#endif
+
+	ChunkFaceMasks::ChunkFaceMasks(const int chunkSize)
+	{
+		m_chunkSize = chunkSize;
+		m_paddedSize = chunkSize + 2;
+
+		m_rows.resize(m_paddedSize * m_paddedSize);
+		m_leftEdge.resize(chunkSize * chunkSize);
+		m_rightEdge.resize(chunkSize * chunkSize);
+		m_masks.resize(6 * chunkSize * chunkSize);
+	}
+
+	void ChunkFaceMasks::build(const Chunk& chunk, const ChunkNeighbors& neighbors, const int yBegin, const int yEnd, const FaceMaskKernel kernel)
+	{
+		LOG_ASSERT((chunk.get_chunk_size() == m_chunkSize), "Face masks built for a different chunk size");
+		LOG_ASSERT(is_supported(kernel), "Face mask kernel is not supported on this cpu");
+		LOG_ASSERT((yBegin >= 0 && yEnd <= m_chunkSize && (yEnd - yBegin) % 4 == 0), "Face mask rows must be whole groups of 4 inside the chunk");
+
+		gather_rows(chunk, neighbors, yBegin, yEnd);
+
+		const int chunkSize = m_chunkSize;
+		const int faceArea = chunkSize * chunkSize;
+		const int count = yEnd - yBegin;
+		for (int z = 0; z < chunkSize; ++z)
+		{
+			auto slab = FaceMaskSlab();
+			slab.Rows = &m_rows[(z + 1) * m_paddedSize + yBegin];
+			slab.Back = &m_rows[z * m_paddedSize + yBegin + 1];
+			slab.Front = &m_rows[(z + 2) * m_paddedSize + yBegin + 1];
+			slab.LeftEdge = &m_leftEdge[z * chunkSize + yBegin];
+			slab.RightEdge = &m_rightEdge[z * chunkSize + yBegin];
+
+			for (int side = 0; side < 6; ++side)
+			{
+				slab.Masks[side] = &m_masks[side * faceArea + z * chunkSize + yBegin];
+			}
+
+			switch (kernel)
+			{
+#if defined(MOXEL_ARCH_X86)
+				case FaceMaskKernel::AVX2: compute_slab_avx2(count, slab); break;
+#endif
+#if defined(MOXEL_ARCH_ARM64)
+				case FaceMaskKernel::NEON: compute_slab_neon(count, slab); break;
+#endif
+				default: compute_slab_scalar(count, slab); break;
+			}
+		}
+	}
+
+	void ChunkFaceMasks::gather_rows(const Chunk& chunk, const ChunkNeighbors& neighbors, const int yBegin, const int yEnd)
+	{
+		const int chunkSize = m_chunkSize;
+		const int last = chunkSize - 1;
+
+		const auto& left = *neighbors[static_cast<int>(Side::LEFT)];
+		const auto& right = *neighbors[static_cast<int>(Side::RIGHT)];
+		const auto& down = *neighbors[static_cast<int>(Side::DOWN)];
+		const auto& up = *neighbors[static_cast<int>(Side::UP)];
+		const auto& back = *neighbors[static_cast<int>(Side::BACK)];
+		const auto& front = *neighbors[static_cast<int>(Side::FRONT)];
+
+		for (int z = 0; z < chunkSize; ++z)
+		{
+			auto* rows = &m_rows[(z + 1) * m_paddedSize];
+
+			// y apron, from the neighbours at the chunk border and from the chunk itself inside
+			rows[yBegin] = yBegin == 0 ? down.get_row(last, z) : chunk.get_row(yBegin - 1, z);
+			rows[yEnd + 1] = yEnd == chunkSize ? up.get_row(0, z) : chunk.get_row(yEnd, z);
+
+			for (int y = yBegin; y < yEnd; ++y)
+			{
+				rows[y + 1] = chunk.get_row(y, z);
+
+				// x apron, moved to the bit the shifted row leaves open
+				m_leftEdge[z * chunkSize + y] = (left.get_row(y, z) >> last) & 1;
+				m_rightEdge[z * chunkSize + y] = (right.get_row(y, z) & 1) << last;
+			}
+		}
+
+		// z apron
+		for (int y = yBegin; y < yEnd; ++y)
+		{
+			m_rows[y + 1] = back.get_row(y, last);
+			m_rows[(chunkSize + 1) * m_paddedSize + y + 1] = front.get_row(y, 0);
+		}
+	}
+
+	FaceMaskKernel ChunkFaceMasks::get_best_kernel()
+	{
+		if (CpuFeatures::has_avx2())
+			return FaceMaskKernel::AVX2;
+
+		if (CpuFeatures::has_neon())
+			return FaceMaskKernel::NEON;
+
+		return FaceMaskKernel::SCALAR;
+	}
+
+	bool ChunkFaceMasks::is_supported(const FaceMaskKernel kernel)
+	{
+		switch (kernel)
+		{
+			case FaceMaskKernel::AVX2: return CpuFeatures::has_avx2();
+			case FaceMaskKernel::NEON: return CpuFeatures::has_neon();
+			default: return true;
+		}
+	}
+
+	const char* ChunkFaceMasks::get_kernel_name(const FaceMaskKernel kernel)
+	{
+		switch (kernel)
+		{
+			case FaceMaskKernel::AVX2: return "avx2";
+			case FaceMaskKernel::NEON: return "neon";
+			default: return "scalar";
+		}
+	}
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "chunk.h"
+#include "chunk_snapshot.h"
+
+#include <vector>
+
+namespace Moxel
+{
+	enum class FaceMaskKernel
+	{
+		SCALAR,
+		AVX2,
+		NEON
+	};
+
+	// visible face bits of a whole chunk, one X row word per (y, z) and Side,
+	// every slab is computed with shifts and and-not over the occupancy rows
+	class ChunkFaceMasks
+	{
+	public:
+		ChunkFaceMasks(int chunkSize);
+
+		void build(const Chunk& chunk, const ChunkNeighbors& neighbors) { build(chunk, neighbors, 0, m_chunkSize, get_best_kernel()); }
+		void build(const Chunk& chunk, const ChunkNeighbors& neighbors, const FaceMaskKernel kernel) { build(chunk, neighbors, 0, m_chunkSize, kernel); }
+
+		// only rows yBegin to yEnd are rebuilt, the others keep their previous masks.
+		// the row count must be a multiple of 4 for the vector kernels
+		void build(const Chunk& chunk, const ChunkNeighbors& neighbors, const int yBegin, const int yEnd) { build(chunk, neighbors, yBegin, yEnd, get_best_kernel()); }
+		void build(const Chunk& chunk, const ChunkNeighbors& neighbors, int yBegin, int yEnd, FaceMaskKernel kernel);
+
+		// chunkSize^2 words, index z * chunkSize + y
+		const uint64_t* get_masks(const Side side) const { return &m_masks[static_cast<size_t>(side) * m_chunkSize * m_chunkSize]; }
+		uint64_t get_mask(const Side side, const int y, const int z) const { return get_masks(side)[z * m_chunkSize + y]; }
+
+		const uint64_t* get_data() const { return m_masks.data(); }
+		size_t get_word_count() const { return m_masks.size(); }
+		int get_chunk_size() const { return m_chunkSize; }
+
+		static FaceMaskKernel get_best_kernel();
+		static bool is_supported(FaceMaskKernel kernel);
+		static const char* get_kernel_name(FaceMaskKernel kernel);
+	private:
+		void gather_rows(const Chunk& chunk, const ChunkNeighbors& neighbors, int yBegin, int yEnd);
+
+		int m_chunkSize = 0;
+		int m_paddedSize = 0;
+
+		std::vector<uint64_t> m_rows; // (N + 2)^2 rows with a face apron, index (z + 1) * (N + 2) + y + 1
+		std::vector<uint64_t> m_leftEdge; // bit 0 set where the left neighbour touches a row
+		std::vector<uint64_t> m_rightEdge; // bit N - 1 set where the right neighbour touches a row
+
+		std::vector<uint64_t> m_masks;
+	};
+}
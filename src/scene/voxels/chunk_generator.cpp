@@ -2,18 +2,37 @@
 #include "render_quad.h"
 #include "engine/renderer/vulkan_renderer.h"
 
-#include <ranges>
+#include <algorithm>
 
 namespace Moxel
 {
 	ChunkBuilder::ChunkBuilder(const ChunkWorldSpecs specs)
+		: m_specs(specs),
+		  m_noise(specs.Seed),
+		  m_dataChunks(specs.RenderDistance * 4 + 1 + get_generation_reach(specs.GenerationPasses) * 2),
+		  m_generationStates(m_dataChunks.get_extent()),
+		  m_meshChunks(specs.RenderDistance * 2 + 1),
+		  m_requestedMeshes(specs.RenderDistance * 2 + 1),
+		  m_dirtySections(specs.RenderDistance * 2 + 1),
+		  m_coldCache(specs.ColdCacheBytes),
+		  m_columnCache(specs.ColumnCacheColumns, specs.ChunkSize)
 	{
-		m_specs = specs;
+		LOG_ASSERT((specs.ChunkSize == 16 || specs.ChunkSize == 32 || specs.ChunkSize == 64), "Chunk size must be 16, 32 or 64");
+		LOG_ASSERT(((1 << specs.ChunkBitSize) == specs.ChunkSize), "Chunk bit size does not match chunk size");
+		LOG_ASSERT((specs.GenerationPasses.empty() == false && is_base_generation_pass(specs.GenerationPasses[0].Type)), "Generation must start with a base pass");
+
+		for (const auto& pass: specs.GenerationPasses)
+		{
+			LOG_ASSERT((&pass == &specs.GenerationPasses[0] || is_base_generation_pass(pass.Type) == false), "Only the first generation pass may be a base pass");
+			LOG_ASSERT((pass.NeighborRadius >= get_min_neighbor_radius(pass.Type)), "Generation pass reads past its neighbor radius");
+			LOG_ASSERT((pass.Depth < specs.ChunkSize), "Generation pass depth must be below the chunk size");
+		}
 	}
 
 	void ChunkBuilder::destroy_world()
 	{ 
 		m_meshChunks.clear();
+		m_dirtySections.clear();
 	}
 
 	int ChunkBuilder::get_total_chunks_data_count() const
@@ -24,13 +43,13 @@ namespace Moxel
 	int ChunkBuilder::get_total_chunks_mesh_count()
 	{
 		int meshes = 0;
-		for (const auto& mesh: m_meshChunks | std::views::values)
+		m_meshChunks.for_each([&meshes](const ChunkPosition&, const std::shared_ptr<ChunkMesh>& mesh)
 		{
 			if (mesh == nullptr || mesh->get_chunk_mesh() == nullptr)
-				continue;
+				return;
 
 			meshes++;
-		}
+		});
 
 		return meshes;
 	}
@@ -59,18 +78,7 @@ namespace Moxel
 		// generate render data
 		m_threadPool.enqueue([this, playerChunkPosition]
 		{
-			for (int i = 0; i < MAX_CHUNKS_DATA_PER_FRAME_GENERATED; i++)
-			{
-				auto lock = std::unique_lock(m_worldMutex);
-
-				if (m_dataGenerationQueue.empty())
-					break;
-
-				const auto position = m_dataGenerationQueue.front();
-				m_dataChunks[position]->generate_data(position);
-
-				m_dataGenerationQueue.pop();
-			}
+			update_data_generation_queue();
 
 			const int renderDistance = m_specs.RenderDistance;
 			for (int i = 0; i < MAX_CHUNKS_PER_FRAME_GENERATED; i++)
@@ -91,56 +99,245 @@ namespace Moxel
 					continue;
 				}
 
-				const auto left = ChunkPosition(position.X - 1, position.Y, position.Z);
-				if (m_dataChunks.contains(left) == false || m_dataChunks[left]->is_processed() == false)
+				// empty chunks need no neighbour data to know they have no mesh
+				if (is_data_ready(position) && m_dataChunks.at(position)->get_summary().is_empty())
+				{
+					m_meshChunks[position] = ChunkMesh::get_empty();
+					m_meshGenerationQueue.pop();
+					continue;
+				}
+
+				if (is_data_ready(ChunkPosition(position.X - 1, position.Y, position.Z)) == false)
 					break;
 
-				const auto down = ChunkPosition(position.X, position.Y - 1, position.Z);
-				if (m_dataChunks.contains(down) == false || m_dataChunks[down]->is_processed() == false)
+				if (is_data_ready(ChunkPosition(position.X, position.Y - 1, position.Z)) == false)
 					break;
 
-				const auto back = ChunkPosition(position.X, position.Y, position.Z - 1);
-				if (m_dataChunks.contains(back) == false || m_dataChunks[back]->is_processed() == false)
+				if (is_data_ready(ChunkPosition(position.X, position.Y, position.Z - 1)) == false)
 					break;
 
-				const auto right = ChunkPosition(position.X + 1, position.Y, position.Z);
-				if (m_dataChunks.contains(right) == false || m_dataChunks[right]->is_processed() == false)
+				if (is_data_ready(ChunkPosition(position.X + 1, position.Y, position.Z)) == false)
 					break;
 
-				const auto up = ChunkPosition(position.X, position.Y + 1, position.Z);
-				if (m_dataChunks.contains(up) == false || m_dataChunks[up]->is_processed() == false)
+				if (is_data_ready(ChunkPosition(position.X, position.Y + 1, position.Z)) == false)
 					break;
 
-				const auto front = ChunkPosition(position.X, position.Y, position.Z + 1);
-				if (m_dataChunks.contains(front) == false || m_dataChunks[front]->is_processed() == false)
+				if (is_data_ready(ChunkPosition(position.X, position.Y, position.Z + 1)) == false)
 					break;
 
-				generate_chunk_mesh(position);
+				generate_chunk_mesh(position, get_lod(position, playerChunkPosition));
 
 				m_meshGenerationQueue.pop();
 			}
 		});
 
-		for (const auto& [position, array]: m_requestedMeshes)
+		if (m_requestedMeshes.empty() == false)
 		{
-			const auto vao = std::make_shared<VulkanVertexArray>(array.first, array.second);
-			m_meshChunks[position] = std::make_shared<ChunkMesh>(vao);
+			m_requestedMeshes.for_each([this](const ChunkPosition& position, auto& data)
+			{
+				m_meshChunks[position] = ChunkMesh::create(std::move(data), m_specs.ChunkSize);
+			});
+			m_requestedMeshes.clear();
 		}
-		m_requestedMeshes.clear();
+
+		// after uploads, so a full mesh built before an edit is patched rather than kept
+		update_dirty_meshes(playerChunkPosition);
 
 		update_render_queue(playerChunkPosition);
 		m_oldPlayerChunkPosition = playerChunkPosition;
 	}
 
-	void ChunkBuilder::enqueue_data_generation(ChunkPosition position)
+	void ChunkBuilder::enqueue_data_generation(const ChunkPosition position, const int targetStage)
 	{
-		if (m_dataChunks.contains(position))
+		auto chunk = m_dataChunks.find(position);
+		if (chunk == nullptr)
+		{
+			const auto created = Chunk::create(m_specs.ChunkSize);
+			m_dataChunks.emplace(position, created);
+			chunk = m_dataChunks.find(position);
+
+			// the state outlives evictions, so a chunk still in the queue is not queued twice
+			auto& state = m_generationStates[position];
+			state.Stages.clear();
+			state.TargetStage = 0;
+			state.IsRunning = false;
+
+			// recently evicted chunks come back from the cold tier instead of noise
+			m_coldCache.restore(position, *created);
+		}
+
+		// processed data is final, only the passes of neighbours still need its stages
+		if ((*chunk)->is_processed() && targetStage == static_cast<int>(m_specs.GenerationPasses.size()))
 			return;
 
-		const auto chunk = std::make_shared<Chunk>(m_specs.ChunkSize * m_specs.ChunkSize * m_specs.ChunkSize);
-		m_dataChunks.emplace(position, chunk);
+		// chunks generated part way for a neighbour go further when something needs more of them
+		auto& state = m_generationStates[position];
+		if (static_cast<int>(state.Stages.size()) >= targetStage)
+			return;
+
+		state.TargetStage = std::max(state.TargetStage, targetStage);
+
+		if (state.IsQueued == false)
+		{
+			state.IsQueued = true;
+			m_dataGenerationQueue.emplace(position);
+		}
+	}
+
+	void ChunkBuilder::update_data_generation_queue()
+	{
+		auto lock = std::unique_lock(m_worldMutex);
+
+		// every queued chunk is looked at once, the ones still short of their target go to the back
+		const int queued = static_cast<int>(m_dataGenerationQueue.size());
+		for (int i = 0; i < queued && m_runningPasses < MAX_GENERATION_PASSES_RUNNING; ++i)
+		{
+			const auto position = m_dataGenerationQueue.front();
+			m_dataGenerationQueue.pop();
+
+			const auto state = m_generationStates.find(position);
+			if (state == nullptr)
+				continue;
+
+			const auto chunk = m_dataChunks.find(position);
+			if (chunk == nullptr || static_cast<int>(state->Stages.size()) >= state->TargetStage)
+			{
+				state->IsQueued = false;
+				continue;
+			}
+
+			if (state->IsRunning == false)
+				start_generation_pass(position);
+
+			m_dataGenerationQueue.emplace(position);
+		}
+	}
+
+	bool ChunkBuilder::start_generation_pass(const ChunkPosition position)
+	{
+		const auto& passes = m_specs.GenerationPasses;
+		const auto& stages = m_generationStates.at(position).Stages;
+		const int pass = static_cast<int>(stages.size());
+
+		// neighbours have to finish the pass before this one first, missing ones are requested that far
+		const int radius = get_dependency_radius(passes, pass);
+		bool isReady = true;
+		for (int z = -radius; z <= radius; ++z)
+		{
+			for (int y = -radius; y <= radius; ++y)
+			{
+				for (int x = -radius; x <= radius; ++x)
+				{
+					const auto neighbor = ChunkPosition(position.X + x, position.Y + y, position.Z + z);
+					if (neighbor == position)
+						continue;
+
+					enqueue_data_generation(neighbor, pass);
+					isReady = isReady && get_generation_stage(neighbor) >= pass;
+				}
+			}
+		}
+
+		if (isReady == false)
+			return false;
+
+		// the base pass fills the chunk from nothing and reads no neighbours
+		const auto source = pass == 0 ? std::shared_ptr<const Chunk>(Chunk::create(m_specs.ChunkSize)) : stages.back();
+		const int neighborRadius = pass == 0 ? 0 : passes[pass].NeighborRadius;
+
+		// neighbours are read as the previous pass left them, even when they went further since
+		auto neighbors = GenerationNeighborhood(m_specs.ChunkSize, neighborRadius);
+		for (int z = -neighborRadius; z <= neighborRadius; ++z)
+		{
+			for (int y = -neighborRadius; y <= neighborRadius; ++y)
+			{
+				for (int x = -neighborRadius; x <= neighborRadius; ++x)
+				{
+					const auto neighbor = ChunkPosition(position.X + x, position.Y + y, position.Z + z);
+					neighbors.set(glm::ivec3(x, y, z), neighbor == position ? source : m_generationStates.at(neighbor).Stages[pass - 1]);
+				}
+			}
+		}
+
+		m_generationStates.at(position).IsRunning = true;
+		m_runningPasses++;
+
+		// passes run unlocked on any worker, chunks from different stages in parallel
+		m_threadPool.enqueue([this, position, source, neighbors = std::move(neighbors), pass]
+		{
+			run_generation_pass(position, source, neighbors, pass);
+		});
+
+		return true;
+	}
+
+	void ChunkBuilder::run_generation_pass(const ChunkPosition position, const std::shared_ptr<const Chunk>& source, const GenerationNeighborhood& neighbors, const int pass)
+	{
+		// passes write a copy, so chunks other passes are reading never change under them
+		const auto result = source->clone();
+		apply_generation_pass(m_specs.GenerationPasses[pass], *result, position, neighbors, m_noise, m_columnCache, m_specs.NoiseSampleStep);
+		result->set_generation_stage(pass + 1);
+
+		if (pass + 1 == static_cast<int>(m_specs.GenerationPasses.size()))
+			result->mark_processed();
+
+		auto lock = std::unique_lock(m_worldMutex);
+		m_runningPasses--;
+
+		const auto state = m_generationStates.find(position);
+		if (state == nullptr)
+			return;
+
+		state->IsRunning = false;
+
+		// dropped if the chunk was evicted or its stages were reset while the pass ran
+		const auto chunk = m_dataChunks.find(position);
+		if (chunk == nullptr || static_cast<int>(state->Stages.size()) != pass)
+			return;
+
+		state->Stages.push_back(result);
+
+		// loaded and edited chunks keep their own data, the passes only rebuild their stages
+		if ((*chunk)->is_processed() == false)
+			*chunk = result;
+	}
+
+	int ChunkBuilder::get_generation_stage(const ChunkPosition position) const
+	{
+		const auto state = m_generationStates.find(position);
+		if (state == nullptr || m_dataChunks.contains(position) == false)
+			return -1;
+
+		return static_cast<int>(state->Stages.size());
+	}
+
+	// chunks next to ones still being generated are read by their passes
+	bool ChunkBuilder::is_generation_dependency(const ChunkPosition position) const
+	{
+		int radius = 0;
+		for (int pass = 0; pass < static_cast<int>(m_specs.GenerationPasses.size()); ++pass)
+		{
+			radius = std::max(radius, get_dependency_radius(m_specs.GenerationPasses, pass));
+		}
+
+		for (int z = -radius; z <= radius; ++z)
+		{
+			for (int y = -radius; y <= radius; ++y)
+			{
+				for (int x = -radius; x <= radius; ++x)
+				{
+					const auto neighbor = ChunkPosition(position.X + x, position.Y + y, position.Z + z);
+					const auto chunk = m_dataChunks.find(neighbor);
+					if (chunk == nullptr)
+						continue;
+
+					if (const auto state = m_generationStates.find(neighbor); (*chunk)->is_processed() == false || (state != nullptr && state->IsQueued))
+						return true;
+				}
+			}
+		}
 
-		m_dataGenerationQueue.emplace(position);
+		return false;
 	}
 
 	void ChunkBuilder::update_mesh_generation_queue(const ChunkPosition playerChunkPosition)
@@ -157,8 +354,14 @@ namespace Moxel
 
 					auto chunkPosition = ChunkPosition(x, y, z);
 
-					if (m_meshChunks.contains(chunkPosition))
+					// meshes whose level changed are rebuilt like edits, the old one draws until then
+					if (const auto mesh = m_meshChunks.find(chunkPosition); mesh != nullptr)
+					{
+						if (*mesh != nullptr && *mesh != ChunkMesh::get_empty() && (*mesh)->get_lod() != get_lod(chunkPosition, playerChunkPosition))
+							mark_dirty(chunkPosition, ALL_MESH_SECTIONS);
+
 						continue;
+					}
 
 					enqueue_data_generation(chunkPosition);
 					enqueue_data_generation(ChunkPosition(x + 1, y, z));
@@ -179,7 +382,7 @@ namespace Moxel
 	{
 		const int renderDistance = m_specs.RenderDistance;
 
-		for (const auto& position: m_meshChunks | std::views::keys)
+		m_meshChunks.for_each([this, renderDistance, playerChunkPosition](const ChunkPosition& position, const std::shared_ptr<ChunkMesh>& mesh)
 		{
 			const auto xDistance = abs(position.X - playerChunkPosition.X);
 			const auto yDistance = abs(position.Y - playerChunkPosition.Y);
@@ -187,63 +390,79 @@ namespace Moxel
 
 			if (xDistance < renderDistance && yDistance < renderDistance && zDistance < renderDistance)
 			{
-				if (m_meshChunks[position] == nullptr || m_meshChunks[position]->get_chunk_mesh() == nullptr)
-					continue;
+				if (mesh == nullptr || mesh->get_chunk_mesh() == nullptr)
+					return;
 
-				m_renderQueue.emplace(position, m_meshChunks[position]);
+				m_renderQueue.emplace(position, mesh);
 			}
-		}
+		});
 	}
 
-
 	void ChunkBuilder::update_data_deletion_queue(const ChunkPosition playerChunkPosition)
 	{
 		auto lock = std::unique_lock(m_worldMutex);
 
 		const int renderDistance = m_specs.RenderDistance;
 		auto chunksToErase = std::vector<ChunkPosition>();
-		for (const auto& position: m_dataChunks | std::views::keys)
+		m_dataChunks.for_each([this, renderDistance, playerChunkPosition, &chunksToErase](const ChunkPosition& position, const std::shared_ptr<Chunk>& chunk)
 		{
-			const auto right = ChunkPosition(position.X + 1, position.Y, position.Z);
-			const auto up = ChunkPosition(position.X, position.Y + 1, position.Z);
-			const auto front = ChunkPosition(position.X, position.Y, position.Z + 1);
-			const auto left = ChunkPosition(position.X - 1, position.Y, position.Z);
-			const auto down = ChunkPosition(position.X, position.Y - 1, position.Z);
-			const auto back = ChunkPosition(position.X, position.Y, position.Z - 1);
-
-			if (m_meshChunks.contains(right) && m_meshChunks[right] != nullptr 
-				&& m_meshChunks.contains(up) && m_meshChunks[up] != nullptr 
-				&& m_meshChunks.contains(front) && m_meshChunks[front] != nullptr 
-				&& m_meshChunks.contains(left) && m_meshChunks[left] != nullptr 
-				&& m_meshChunks.contains(down) && m_meshChunks[down] != nullptr 
-				&& m_meshChunks.contains(back) && m_meshChunks[back] != nullptr)
+			// stages of finished chunks are kept only while a neighbour's passes may read them
+			const bool isDependency = is_generation_dependency(position);
+			if (chunk->is_processed() && isDependency == false)
+				clear_generation_stages(position);
+
+			// edited chunks stay until their sections are remeshed
+			if (const auto sections = m_dirtySections.find(position); sections != nullptr && *sections != 0)
+				return;
+
+			if (is_mesh_ready(ChunkPosition(position.X + 1, position.Y, position.Z))
+				&& is_mesh_ready(ChunkPosition(position.X, position.Y + 1, position.Z))
+				&& is_mesh_ready(ChunkPosition(position.X, position.Y, position.Z + 1))
+				&& is_mesh_ready(ChunkPosition(position.X - 1, position.Y, position.Z))
+				&& is_mesh_ready(ChunkPosition(position.X, position.Y - 1, position.Z))
+				&& is_mesh_ready(ChunkPosition(position.X, position.Y, position.Z - 1))
+				&& isDependency == false)
 			{
 				chunksToErase.emplace_back(position);
 
-				continue;
+				return;
 			}
 
 			const auto xDistance = abs(position.X - playerChunkPosition.X);
 			const auto yDistance = abs(position.Y - playerChunkPosition.Y);
 			const auto zDistance = abs(position.Z - playerChunkPosition.Z);
 
-			if (xDistance > renderDistance * 2 || yDistance > renderDistance * 2 || zDistance > renderDistance * 2)
+			// dependencies of the outermost meshes sit up to the generation reach further out
+			const int maxDistance = renderDistance * 2 + get_generation_reach(m_specs.GenerationPasses);
+			if (xDistance > maxDistance || yDistance > maxDistance || zDistance > maxDistance)
 				chunksToErase.emplace_back(position);
-		}
+		});
 
 		for (const auto& position: chunksToErase)
 		{
+			m_coldCache.store(position, *m_dataChunks.at(position));
 			m_dataChunks.erase(position);
+			clear_generation_stages(position);
 		}
 	}
 
+	void ChunkBuilder::clear_generation_stages(const ChunkPosition position)
+	{
+		const auto state = m_generationStates.find(position);
+		if (state == nullptr)
+			return;
+
+		state->Stages.clear();
+		state->TargetStage = 0;
+	}
+
 	void ChunkBuilder::update_mesh_deletion_queue(const ChunkPosition playerChunkPosition)
 	{
 		auto lock = std::unique_lock(m_worldMutex);
 
 		auto chunksToErase = std::vector<ChunkPosition>();
 		const auto renderDistance = m_specs.RenderDistance;
-		for (const auto& position: m_meshChunks | std::views::keys)
+		m_meshChunks.for_each([renderDistance, playerChunkPosition, &chunksToErase](const ChunkPosition& position, const std::shared_ptr<ChunkMesh>& mesh)
 		{
 			const auto xDistance = abs(position.X - playerChunkPosition.X);
 			const auto yDistance = abs(position.Y - playerChunkPosition.Y);
@@ -251,12 +470,12 @@ namespace Moxel
 
 			if (xDistance > renderDistance || yDistance > renderDistance || zDistance > renderDistance)
 			{
-				if (m_meshChunks[position] == nullptr)
-					continue;
+				if (mesh == nullptr)
+					return;
 
 				chunksToErase.emplace_back(position);
 			}
-		}
+		});
 
 		for (const auto& position: chunksToErase)
 		{
@@ -264,6 +483,20 @@ namespace Moxel
 		}
 	}
 
+	bool ChunkBuilder::is_data_ready(const ChunkPosition position) const
+	{
+		const auto chunk = m_dataChunks.find(position);
+
+		return chunk != nullptr && (*chunk)->is_processed();
+	}
+
+	bool ChunkBuilder::is_mesh_ready(const ChunkPosition position) const
+	{
+		const auto mesh = m_meshChunks.find(position);
+
+		return mesh != nullptr && *mesh != nullptr;
+	}
+
 	glm::vec3 ChunkBuilder::chunk_to_world_pos(const glm::vec3 chunkPosition) const
 	{ 
 		return chunkPosition * static_cast<float>(m_specs.ChunkSize);
@@ -280,131 +513,205 @@ namespace Moxel
 		};
 	}
 
-	bool ChunkBuilder::get_voxel(ChunkPosition position, const int x, const int y, const int z) const
+	ChunkNeighbors ChunkBuilder::get_neighbors(const ChunkPosition position) const
 	{
-		const auto chunkSize = m_specs.ChunkSize;
-		int actualX = x, actualY = y, actualZ = z;
+		auto neighbors = ChunkNeighbors();
+		neighbors[static_cast<int>(Side::FRONT)] = m_dataChunks.at(ChunkPosition(position.X, position.Y, position.Z + 1)).get();
+		neighbors[static_cast<int>(Side::BACK)] = m_dataChunks.at(ChunkPosition(position.X, position.Y, position.Z - 1)).get();
+		neighbors[static_cast<int>(Side::LEFT)] = m_dataChunks.at(ChunkPosition(position.X - 1, position.Y, position.Z)).get();
+		neighbors[static_cast<int>(Side::RIGHT)] = m_dataChunks.at(ChunkPosition(position.X + 1, position.Y, position.Z)).get();
+		neighbors[static_cast<int>(Side::UP)] = m_dataChunks.at(ChunkPosition(position.X, position.Y + 1, position.Z)).get();
+		neighbors[static_cast<int>(Side::DOWN)] = m_dataChunks.at(ChunkPosition(position.X, position.Y - 1, position.Z)).get();
+
+		return neighbors;
+	}
 
-		if (x < 0 || x >= chunkSize)
+	// every neighbour face touching this chunk is solid, so nothing inside can be seen
+	bool ChunkBuilder::is_enclosed(const ChunkPosition position) const
+	{
+		const auto neighbors = get_neighbors(position);
+		for (int side = 0; side < 6; ++side)
 		{
-			actualX = x < 0 ? chunkSize - 1 : 0;
-			position.X += x < 0 ? -1 : 1;
+			const auto facing = get_opposite_side(static_cast<Side>(side));
+			if (neighbors[side]->get_summary().is_face_solid(facing) == false)
+				return false;
 		}
 
-		if (y < 0 || y >= chunkSize)
-		{
-			actualY = y < 0 ? chunkSize - 1 : 0;
-			position.Y += y < 0 ? -1 : 1;
-		}
+		return true;
+	}
+
+	int ChunkBuilder::get_lod(const ChunkPosition position, const ChunkPosition playerChunkPosition) const
+	{
+		const auto distance = std::max({ abs(position.X - playerChunkPosition.X), abs(position.Y - playerChunkPosition.Y), abs(position.Z - playerChunkPosition.Z) });
 
-		if (z < 0 || z >= chunkSize)
+		int lod = 0;
+		while (lod < MAX_LOD_LEVELS && m_specs.LodDistances[lod] > 0 && distance >= m_specs.LodDistances[lod])
 		{
-			actualZ = z < 0 ? chunkSize - 1 : 0;
-			position.Z += z < 0 ? -1 : 1;
+			lod++;
 		}
 
-		return m_dataChunks.at(position)->get_block(actualZ * chunkSize * chunkSize + actualY * chunkSize + actualX);
+		return lod;
 	}
 
-	void ChunkBuilder::generate_chunk_mesh(ChunkPosition position)
+	void ChunkBuilder::generate_chunk_mesh(const ChunkPosition position, const int lod)
 	{
-		// generate mesh data from chunk
-		auto totalVertices = std::vector<VoxelVertex>();
-		auto totalIndices = std::vector<uint32_t>();
-		int indexOffset = 0;
+		const auto& chunk = m_dataChunks.at(position);
+		const auto& summary = chunk->get_summary();
 
-		const int chunkSize = m_specs.ChunkSize;
-		for (int z = 0; z < chunkSize; ++z)
+		// resolved from summaries without touching per-voxel data
+		if (summary.is_empty() || (summary.is_full() && is_enclosed(position)))
 		{
-			for (int y = 0; y < chunkSize; ++y)
-			{
-				for (int x = 0; x < chunkSize; ++x)
-				{
-					const auto mainBlock = m_dataChunks.at(position)->get_block(z * chunkSize * chunkSize + y * chunkSize + x);
-					if (mainBlock == false)
-						continue;
+			m_meshChunks[position] = ChunkMesh::get_empty();
+			return;
+		}
 
-					const auto positionOffset = glm::i32vec3(x, y, z);
-					int indexQuadOffset = 0;
+		// generate mesh data from chunk into the worker's reusable arena
+		thread_local auto arena = ChunkMeshArena();
+		arena.clear();
 
-					const auto leftBlock = get_voxel(position, x - 1, y, z);
-					const auto downBlock = get_voxel(position, x, y - 1, z);
-					const auto backBlock = get_voxel(position, x, y, z - 1);
-					const auto rightBlock = get_voxel(position, x + 1, y, z);
-					const auto upBlock = get_voxel(position, x, y + 1, z);
-					const auto frontBlock = get_voxel(position, x, y, z + 1);
+		if (lod == 0)
+			mesh_chunk(m_specs.Meshing, *chunk, get_neighbors(position), arena);
+		else
+			mesh_chunk_lod(*chunk, get_neighbors(position), lod, m_specs.LodDownsampling, arena);
 
-					if (downBlock == false)
-					{
-						auto quadDown = RenderQuad(Side::DOWN, positionOffset);
-						quadDown.add_indices_offset(indexOffset + indexQuadOffset);
-						totalVertices.insert(totalVertices.end(), quadDown.get_vertices().begin(), quadDown.get_vertices().end());
-						totalIndices.insert(totalIndices.end(), quadDown.get_indices().begin(), quadDown.get_indices().end());
+		// only full resolution meshes are empty at every level
+		if (arena.empty())
+		{
+			m_meshChunks[position] = lod == 0 ? ChunkMesh::get_empty() : ChunkMesh::get_empty(lod);
+			return;
+		}
 
-						indexQuadOffset += 4;
-					}
+		// exact sized copies wait for upload on the main thread
+		static const auto noFaces = ChunkMeshData();
+		auto& data = m_requestedMeshes[position];
+		arena.write_mesh(data, noFaces, ALL_MESH_SECTIONS, get_mesh_section_count(m_specs.ChunkSize));
+		data.Lod = lod;
+	}
 
-					if (upBlock == false)
-					{
-						auto quadUp = RenderQuad(Side::UP, positionOffset);
-						quadUp.add_indices_offset(indexOffset + indexQuadOffset);
-						totalVertices.insert(totalVertices.end(), quadUp.get_vertices().begin(), quadUp.get_vertices().end());
-						totalIndices.insert(totalIndices.end(), quadUp.get_indices().begin(), quadUp.get_indices().end());
+	bool ChunkBuilder::set_block(const glm::ivec3 worldVoxel, const BlockId block)
+	{
+		auto lock = std::unique_lock(m_worldMutex);
 
-						indexQuadOffset += 4;
-					}
+		const int chunkSize = m_specs.ChunkSize;
+		const int bits = m_specs.ChunkBitSize;
+		const auto position = ChunkPosition(worldVoxel.x >> bits, worldVoxel.y >> bits, worldVoxel.z >> bits);
+		const int x = worldVoxel.x & (chunkSize - 1);
+		const int y = worldVoxel.y & (chunkSize - 1);
+		const int z = worldVoxel.z & (chunkSize - 1);
+
+		// evicted chunks come back from the cold cache, others have to be generated first
+		enqueue_data_generation(position);
+		if (is_data_ready(position) == false)
+			return false;
+
+		auto& chunk = m_dataChunks.at(position);
+		const int index = z * chunkSize * chunkSize + y * chunkSize + x;
+		if (chunk->get_block_type(index) == block)
+			return true;
+
+		// generation passes of nearby chunks may still hold it, edits go to a copy then
+		if (chunk.use_count() > 1)
+			chunk = chunk->clone();
+
+		chunk->set_block_type(index, block);
+
+		// neighbour faces only change along the shared border
+		const int last = chunkSize - 1;
+		const uint32_t section = get_mesh_section_bit(y);
+		mark_dirty(position, get_edit_sections(y, chunkSize));
+
+		if (x == 0)
+			mark_dirty(ChunkPosition(position.X - 1, position.Y, position.Z), section);
+		if (x == last)
+			mark_dirty(ChunkPosition(position.X + 1, position.Y, position.Z), section);
+		if (z == 0)
+			mark_dirty(ChunkPosition(position.X, position.Y, position.Z - 1), section);
+		if (z == last)
+			mark_dirty(ChunkPosition(position.X, position.Y, position.Z + 1), section);
+		if (y == 0)
+			mark_dirty(ChunkPosition(position.X, position.Y - 1, position.Z), get_mesh_section_bit(last));
+		if (y == last)
+			mark_dirty(ChunkPosition(position.X, position.Y + 1, position.Z), get_mesh_section_bit(0));
+
+		return true;
+	}
 
-					if (leftBlock == false)
-					{
-						auto quadLeft = RenderQuad(Side::LEFT, positionOffset);
-						quadLeft.add_indices_offset(indexOffset + indexQuadOffset);
-						totalVertices.insert(totalVertices.end(), quadLeft.get_vertices().begin(), quadLeft.get_vertices().end());
-						totalIndices.insert(totalIndices.end(), quadLeft.get_indices().begin(), quadLeft.get_indices().end());
+	void ChunkBuilder::mark_dirty(const ChunkPosition position, const uint32_t sections)
+	{
+		// chunks without a mesh entry are meshed in full once they come into range
+		if (m_meshChunks.contains(position) == false)
+			return;
 
-						indexQuadOffset += 4;
-					}
+		m_dirtySections[position] |= sections;
+	}
 
-					if (rightBlock == false)
-					{
-						auto quadRight = RenderQuad(Side::RIGHT, positionOffset);
-						quadRight.add_indices_offset(indexOffset + indexQuadOffset);
-						totalVertices.insert(totalVertices.end(), quadRight.get_vertices().begin(), quadRight.get_vertices().end());
-						totalIndices.insert(totalIndices.end(), quadRight.get_indices().begin(), quadRight.get_indices().end());
+	void ChunkBuilder::update_dirty_meshes(const ChunkPosition playerChunkPosition)
+	{
+		auto lock = std::unique_lock(m_worldMutex);
 
-						indexQuadOffset += 4;
-					}
+		int remeshed = 0;
+		m_dirtySections.for_each([this, playerChunkPosition, &remeshed](const ChunkPosition& position, uint32_t& sections)
+		{
+			if (sections == 0 || remeshed == MAX_DIRTY_CHUNKS_PER_FRAME)
+				return;
 
-					if (backBlock == false)
-					{
-						auto quadBack = RenderQuad(Side::BACK, positionOffset);
-						quadBack.add_indices_offset(indexOffset + indexQuadOffset);
-						totalVertices.insert(totalVertices.end(), quadBack.get_vertices().begin(), quadBack.get_vertices().end());
-						totalIndices.insert(totalIndices.end(), quadBack.get_indices().begin(), quadBack.get_indices().end());
+			// a mesh that is still being generated reads the edited data anyway
+			if (is_mesh_ready(position) == false)
+			{
+				sections = 0;
+				return;
+			}
 
-						indexQuadOffset += 4;
-					}
+			// evicted neighbours are restored first, the sections stay dirty until they are back
+			bool isReady = true;
+			for (const auto& required: {
+				position,
+				ChunkPosition(position.X - 1, position.Y, position.Z), ChunkPosition(position.X + 1, position.Y, position.Z),
+				ChunkPosition(position.X, position.Y - 1, position.Z), ChunkPosition(position.X, position.Y + 1, position.Z),
+				ChunkPosition(position.X, position.Y, position.Z - 1), ChunkPosition(position.X, position.Y, position.Z + 1) })
+			{
+				enqueue_data_generation(required);
+				isReady = isReady && is_data_ready(required);
+			}
 
-					if (frontBlock == false)
-					{
-						auto quadFront = RenderQuad(Side::FRONT, positionOffset);
-						quadFront.add_indices_offset(indexOffset + indexQuadOffset);
-						totalVertices.insert(totalVertices.end(), quadFront.get_vertices().begin(), quadFront.get_vertices().end());
-						totalIndices.insert(totalIndices.end(), quadFront.get_indices().begin(), quadFront.get_indices().end());
+			if (isReady == false)
+				return;
 
-						indexQuadOffset += 4;
-					}
+			remesh_sections(position, sections, get_lod(position, playerChunkPosition));
+			sections = 0;
+			remeshed++;
+		});
+	}
 
-					indexOffset += indexQuadOffset;
-				}
-			}
-		}
+	void ChunkBuilder::remesh_sections(const ChunkPosition position, uint32_t sections, const int lod)
+	{
+		const auto& chunk = m_dataChunks.at(position);
+		static const auto noFaces = ChunkMeshData();
 
-		if (totalIndices.empty())
+		// downsampled meshes and level changes are rebuilt whole
+		const auto* previous = &m_meshChunks.at(position)->get_data();
+		if (lod != 0 || previous->Lod != 0)
 		{
-			m_meshChunks[position] = std::make_shared<ChunkMesh>(nullptr);
-			return;
+			sections = ALL_MESH_SECTIONS;
+			previous = &noFaces;
 		}
 
-		m_requestedMeshes[position] = std::pair(totalIndices, totalVertices);
+		thread_local auto arena = ChunkMeshArena();
+		arena.clear();
+
+		if (lod == 0)
+			mesh_chunk(m_specs.Meshing, *chunk, get_neighbors(position), arena, sections);
+		else
+			mesh_chunk_lod(*chunk, get_neighbors(position), lod, m_specs.LodDownsampling, arena);
+
+		// untouched sections are copied from the current mesh
+		auto data = ChunkMeshData();
+		arena.write_mesh(data, *previous, sections, get_mesh_section_count(m_specs.ChunkSize));
+		data.Lod = lod;
+
+		if (data.Faces.empty())
+			m_meshChunks[position] = lod == 0 ? ChunkMesh::get_empty() : ChunkMesh::get_empty(lod);
+		else
+			m_meshChunks[position] = ChunkMesh::create(std::move(data), m_specs.ChunkSize);
 	}
 }
@@ -1,7 +1,14 @@
 #pragma once
 
 #include "chunk.h"
+#include "chunk_cache.h"
+#include "chunk_grid.h"
+#include "chunk_lod.h"
+#include "chunk_mesher.h"
+#include "chunk_snapshot.h"
+#include "column_cache.h"
 #include "render_quad.h"
+#include "world_generation.h"
 #include "engine/core/thread_pool.h"
 
 #include <glm/glm.hpp>
@@ -13,10 +20,26 @@ namespace Moxel
 {
 	struct ChunkWorldSpecs
 	{
-		int ChunkSize = 16;
+		int ChunkSize = 16; // 16, 32 or 64, each has a compiled ChunkLayout
 		int ChunkBitSize = 4; // 2^4 = 16
 
+		uint32_t Seed = 123456u; // terrain noise permutation
+		int NoiseSampleStep = 1; // noise every 1, 2, 4 or 8 voxels, trilinear in between
+
+		// run in order on every chunk, the first one is always a base density or base height pass.
+		// get_layered_generation_passes adds caves, surface, ores and decorations,
+		// get_height_generation_passes lays them over a base height pass
+		std::vector<GenerationPass> GenerationPasses = { GenerationPass() };
+		size_t ColumnCacheColumns = 1024; // 2d fields of the base height pass per (x, z) column, LRU
 		int RenderDistance = 5;
+		MeshingMode Meshing = MeshingMode::GREEDY;
+
+		// chunks at least LodDistances[i] chunks from the player are meshed from a grid
+		// downsampled 2^(i + 1) times, 0 turns that level and the ones after it off
+		std::array<int, MAX_LOD_LEVELS> LodDistances = { 4, 8, 16 };
+		LodRule LodDownsampling = LodRule::MAJORITY;
+
+		size_t ColdCacheBytes = 64ull << 20; // compressed evicted chunks, 0 disables the tier
 	};
 
 	class ChunkBuilder
@@ -30,32 +53,76 @@ namespace Moxel
 		void update(glm::vec3 playerPosition);
 		void destroy_world();
 
+		// edits one voxel, false while its chunk has no data yet. only the touched mesh
+		// sections are rebuilt on the next update, neighbours only for border voxels.
+		// those remeshes run on the main thread under the world lock, see update_dirty_meshes
+		bool set_block(glm::ivec3 worldVoxel, BlockId block);
+
 		int get_total_chunks_data_count() const;
 		int get_total_chunks_mesh_count();
+		const ChunkCacheStats& get_cold_cache_stats() const { return m_coldCache.get_stats(); }
+		ColumnCacheStats get_column_cache_stats() const { return m_columnCache.get_stats(); }
 
 		std::queue<std::pair<ChunkPosition, std::shared_ptr<ChunkMesh>>>& get_render_queue() { return m_renderQueue; }
 	private:
-		void generate_chunk_mesh(ChunkPosition position);
-		bool get_voxel(ChunkPosition position, int x, int y, int z) const;
+		void generate_chunk_mesh(ChunkPosition position, int lod);
+		int get_lod(ChunkPosition position, ChunkPosition playerChunkPosition) const;
+		ChunkNeighbors get_neighbors(ChunkPosition position) const;
+		bool is_data_ready(ChunkPosition position) const;
+		bool is_mesh_ready(ChunkPosition position) const;
+		bool is_enclosed(ChunkPosition position) const;
 
 		void update_mesh_generation_queue(ChunkPosition playerChunkPosition);
 		void update_mesh_deletion_queue(ChunkPosition playerChunkPosition);
 
-		void enqueue_data_generation(ChunkPosition position);
+		// chunks are generated up to targetStage passes, dependencies of other chunks stop part way.
+		// loaded and edited chunks only regenerate their stages when a neighbour's pass reads them
+		void enqueue_data_generation(ChunkPosition position) { enqueue_data_generation(position, static_cast<int>(m_specs.GenerationPasses.size())); }
+		void enqueue_data_generation(ChunkPosition position, int targetStage);
+		void update_data_generation_queue();
+		bool start_generation_pass(ChunkPosition position);
+		void run_generation_pass(ChunkPosition position, const std::shared_ptr<const Chunk>& source, const GenerationNeighborhood& neighbors, int pass);
+		int get_generation_stage(ChunkPosition position) const;
+		bool is_generation_dependency(ChunkPosition position) const;
+		void clear_generation_stages(ChunkPosition position);
 		void update_data_deletion_queue(ChunkPosition playerChunkPosition);
 
 		void update_render_queue(ChunkPosition playerChunkPosition);
 
+		void mark_dirty(ChunkPosition position, uint32_t sections);
+		// main thread, holds m_worldMutex while it remeshes up to MAX_DIRTY_CHUNKS_PER_FRAME chunks
+		void update_dirty_meshes(ChunkPosition playerChunkPosition);
+		void remesh_sections(ChunkPosition position, uint32_t sections, int lod);
+
+
 		const int MAX_CHUNKS_PER_FRAME_GENERATED = 16;
-		const int MAX_CHUNKS_DATA_PER_FRAME_GENERATED = 32;
+		const int MAX_GENERATION_PASSES_RUNNING = 32;
+		const int MAX_DIRTY_CHUNKS_PER_FRAME = 16;
 
 		ChunkWorldSpecs m_specs;
+		WorldNoise m_noise; // built once from the seed, shared read only by the workers
 		ChunkPosition m_oldPlayerChunkPosition = {100, 100, 100};
 
-		std::unordered_map<ChunkPosition, std::shared_ptr<Chunk>> m_dataChunks;
-		std::unordered_map<ChunkPosition, std::shared_ptr<ChunkMesh>> m_meshChunks;
+		// what the passes made of a position, apart from its live chunk, so edits and cold cache
+		// restores never reach a neighbour's pass. Stages[i] is the chunk after passes 0..i
+		struct GenerationState
+		{
+			std::vector<std::shared_ptr<const Chunk>> Stages;
+			int TargetStage = 0;
+			bool IsQueued = false;
+			bool IsRunning = false;
+		};
+
+		ChunkGrid<std::shared_ptr<Chunk>> m_dataChunks;
+		ChunkGrid<GenerationState> m_generationStates;
+		int m_runningPasses = 0;
+		ChunkGrid<std::shared_ptr<ChunkMesh>> m_meshChunks;
 
-		std::unordered_map<ChunkPosition, std::pair<std::vector<uint32_t>, std::vector<VoxelVertex>>> m_requestedMeshes;
+		ChunkGrid<ChunkMeshData> m_requestedMeshes;
+		ChunkGrid<uint32_t> m_dirtySections; // mesh sections waiting for a remesh after an edit or a lod change
+
+		ChunkCache m_coldCache;
+		ColumnCache m_columnCache; // shared by the workers, locks on its own
 
 		std::queue<ChunkPosition> m_dataGenerationQueue;
 		std::queue<ChunkPosition> m_meshGenerationQueue;
@@ -63,5 +130,7 @@ namespace Moxel
 
 		std::mutex m_worldMutex;
 		ThreadPool m_threadPool;
+
+		friend class ChunkBenchmark; // drives a builder and reads its chunks back to check edits and generation
 	};
 }
@@ -0,0 +1,156 @@
+#pragma once
+
+#include "chunk.h"
+#include "engine/core/logger/log.h"
+
+#include <vector>
+
+namespace Moxel
+{
+	// fixed capacity toroidal grid, a position lives in slot (position mod extent)
+	// and the stored position tag tells live entries from stale ones
+	template<typename T>
+	class ChunkGrid
+	{
+	public:
+		ChunkGrid(const int extent)
+		{
+			m_extent = extent;
+			m_slots.resize(static_cast<size_t>(extent) * extent * extent);
+		}
+
+		bool contains(const ChunkPosition& position) const { return find(position) != nullptr; }
+
+		T* find(const ChunkPosition& position)
+		{
+			auto& slot = m_slots[get_slot_index(position)];
+
+			return slot.IsOccupied && slot.Position == position ? &slot.Value : nullptr;
+		}
+
+		const T* find(const ChunkPosition& position) const
+		{
+			const auto& slot = m_slots[get_slot_index(position)];
+
+			return slot.IsOccupied && slot.Position == position ? &slot.Value : nullptr;
+		}
+
+		T& at(const ChunkPosition& position)
+		{
+			const auto value = find(position);
+			LOG_ASSERT((value != nullptr), "Chunk position is not in grid");
+
+			return *value;
+		}
+
+		const T& at(const ChunkPosition& position) const
+		{
+			const auto value = find(position);
+			LOG_ASSERT((value != nullptr), "Chunk position is not in grid");
+
+			return *value;
+		}
+
+		// inserts a default value if missing, a stale entry in the same slot is evicted
+		T& operator[](const ChunkPosition& position)
+		{
+			auto& slot = m_slots[get_slot_index(position)];
+			if (slot.IsOccupied && slot.Position == position)
+				return slot.Value;
+
+			occupy(slot, position, T());
+			return slot.Value;
+		}
+
+		void emplace(const ChunkPosition& position, T value)
+		{
+			auto& slot = m_slots[get_slot_index(position)];
+			if (slot.IsOccupied && slot.Position == position)
+				return;
+
+			occupy(slot, position, std::move(value));
+		}
+
+		bool erase(const ChunkPosition& position)
+		{
+			auto& slot = m_slots[get_slot_index(position)];
+			if (slot.IsOccupied == false || (slot.Position == position) == false)
+				return false;
+
+			slot.IsOccupied = false;
+			slot.Value = T();
+			m_size--;
+
+			return true;
+		}
+
+		void clear()
+		{
+			for (auto& slot: m_slots)
+			{
+				slot.IsOccupied = false;
+				slot.Value = T();
+			}
+
+			m_size = 0;
+		}
+
+		// visits live entries in slot order, which is spatial order modulo the wrap
+		template<typename Function>
+		void for_each(Function&& function)
+		{
+			for (auto& slot: m_slots)
+			{
+				if (slot.IsOccupied)
+					function(slot.Position, slot.Value);
+			}
+		}
+
+		template<typename Function>
+		void for_each(Function&& function) const
+		{
+			for (const auto& slot: m_slots)
+			{
+				if (slot.IsOccupied)
+					function(slot.Position, slot.Value);
+			}
+		}
+
+		size_t size() const { return m_size; }
+		bool empty() const { return m_size == 0; }
+		int get_extent() const { return m_extent; }
+	private:
+		struct Slot
+		{
+			ChunkPosition Position = ChunkPosition(0, 0, 0);
+			T Value = T();
+			bool IsOccupied = false;
+		};
+
+		void occupy(Slot& slot, const ChunkPosition& position, T value)
+		{
+			if (slot.IsOccupied == false)
+				m_size++;
+
+			slot.Position = position;
+			slot.Value = std::move(value);
+			slot.IsOccupied = true;
+		}
+
+		int wrap(const int value) const
+		{
+			const int result = value % m_extent;
+
+			return result < 0 ? result + m_extent : result;
+		}
+
+		size_t get_slot_index(const ChunkPosition& position) const
+		{
+			return (static_cast<size_t>(wrap(position.Z)) * m_extent + wrap(position.Y)) * m_extent + wrap(position.X);
+		}
+
+		std::vector<Slot> m_slots;
+		int m_extent = 0;
+		size_t m_size = 0;
+	};
+}
@@ -0,0 +1,190 @@
+#pragma once
+
+#include "chunk.h"
+
+#include <algorithm>
+#include <bit>
+#include <vector>
+
+namespace Moxel
+{
+	// flat robin hood map keyed by packed chunk positions, erase shifts the
+	// following entries back instead of leaving tombstones
+	template<typename T>
+	class ChunkHashMap
+	{
+	public:
+		ChunkHashMap(const size_t capacity = 16) { reserve(capacity); }
+
+		T* find(const ChunkPosition& position)
+		{
+			const auto index = find_index(position.pack());
+
+			return index != NOT_FOUND ? &m_slots[index].Value : nullptr;
+		}
+
+		const T* find(const ChunkPosition& position) const
+		{
+			const auto index = find_index(position.pack());
+
+			return index != NOT_FOUND ? &m_slots[index].Value : nullptr;
+		}
+
+		bool contains(const ChunkPosition& position) const { return find_index(position.pack()) != NOT_FOUND; }
+
+		T& operator[](const ChunkPosition& position) { return *emplace(position, T()).first; }
+
+		std::pair<T*, bool> emplace(const ChunkPosition& position, T value)
+		{
+			const uint64_t key = position.pack();
+			if (const auto index = find_index(key); index != NOT_FOUND)
+				return { &m_slots[index].Value, false };
+
+			if ((m_size + 1) * MAX_LOAD_DENOMINATOR > m_slots.size() * MAX_LOAD_NUMERATOR)
+				rehash(m_slots.size() * 2);
+
+			return { insert_new(key, std::move(value)), true };
+		}
+
+		bool erase(const ChunkPosition& position)
+		{
+			auto index = find_index(position.pack());
+			if (index == NOT_FOUND)
+				return false;
+
+			// backward shift the cluster that follows
+			auto next = (index + 1) & m_mask;
+			while (m_slots[next].Distance > 1)
+			{
+				m_slots[index] = std::move(m_slots[next]);
+				m_slots[index].Distance--;
+
+				index = next;
+				next = (next + 1) & m_mask;
+			}
+
+			m_slots[index] = Slot();
+			m_size--;
+
+			return true;
+		}
+
+		void reserve(const size_t count)
+		{
+			const auto capacity = std::bit_ceil(std::max<size_t>(count * MAX_LOAD_DENOMINATOR / MAX_LOAD_NUMERATOR + 1, 16));
+			if (capacity > m_slots.size())
+				rehash(capacity);
+		}
+
+		void clear()
+		{
+			for (auto& slot: m_slots)
+			{
+				slot = Slot();
+			}
+
+			m_size = 0;
+		}
+
+		template<typename Function>
+		void for_each(Function&& function)
+		{
+			for (auto& slot: m_slots)
+			{
+				if (slot.Distance != 0)
+					function(ChunkPosition::unpack(slot.Key), slot.Value);
+			}
+		}
+
+		template<typename Function>
+		void for_each(Function&& function) const
+		{
+			for (const auto& slot: m_slots)
+			{
+				if (slot.Distance != 0)
+					function(ChunkPosition::unpack(slot.Key), slot.Value);
+			}
+		}
+
+		size_t size() const { return m_size; }
+		bool empty() const { return m_size == 0; }
+		size_t capacity() const { return m_slots.size(); }
+	private:
+		static constexpr size_t NOT_FOUND = ~0ull;
+		static constexpr size_t MAX_LOAD_NUMERATOR = 7;
+		static constexpr size_t MAX_LOAD_DENOMINATOR = 8;
+
+		struct Slot
+		{
+			uint64_t Key = 0;
+			T Value = T();
+			uint32_t Distance = 0; // probe length + 1, zero marks an empty slot
+		};
+
+		size_t find_index(const uint64_t key) const
+		{
+			auto index = ChunkPosition::mix(key) & m_mask;
+			for (uint32_t distance = 1; m_slots[index].Distance >= distance; ++distance)
+			{
+				if (m_slots[index].Key == key)
+					return index;
+
+				index = (index + 1) & m_mask;
+			}
+
+			return NOT_FOUND;
+		}
+
+		T* insert_new(const uint64_t key, T value)
+		{
+			auto entry = Slot();
+			entry.Key = key;
+			entry.Value = std::move(value);
+			entry.Distance = 1;
+
+			T* inserted = nullptr;
+			auto index = ChunkPosition::mix(key) & m_mask;
+			while (true)
+			{
+				auto& slot = m_slots[index];
+				if (slot.Distance == 0)
+				{
+					slot = std::move(entry);
+					m_size++;
+
+					return inserted != nullptr ? inserted : &slot.Value;
+				}
+
+				// take the slot from richer entries
+				if (slot.Distance < entry.Distance)
+				{
+					std::swap(slot, entry);
+					if (inserted == nullptr)
+						inserted = &slot.Value;
+				}
+
+				index = (index + 1) & m_mask;
+				entry.Distance++;
+			}
+		}
+
+		void rehash(const size_t capacity)
+		{
+			auto slots = std::move(m_slots);
+
+			m_slots = std::vector<Slot>(capacity);
+			m_mask = capacity - 1;
+			m_size = 0;
+
+			for (auto& slot: slots)
+			{
+				if (slot.Distance != 0)
+					insert_new(slot.Key, std::move(slot.Value));
+			}
+		}
+
+		std::vector<Slot> m_slots;
+		size_t m_mask = 0;
+		size_t m_size = 0;
+	};
+}
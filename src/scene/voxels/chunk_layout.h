@@ -0,0 +1,43 @@
+#pragma once
+
+#include "engine/core/logger/log.h"
+
+#include <bit>
+#include <cstdint>
+
+namespace Moxel
+{
+	// compile time chunk dimensions, index math folds into shifts and masks
+	template<int Size>
+	struct ChunkLayout
+	{
+		static_assert(Size == 16 || Size == 32 || Size == 64, "Unsupported chunk size");
+
+		static constexpr int SIZE = Size;
+		static constexpr int BIT_SIZE = std::countr_zero(static_cast<unsigned>(Size));
+		static constexpr int VOXEL_COUNT = Size * Size * Size;
+		static constexpr uint64_t ROW_MASK = Size == 64 ? ~0ull : (1ull << Size) - 1;
+
+		// padded snapshot with a one voxel apron
+		static constexpr int PADDED_STRIDE_Y = Size + 2;
+		static constexpr int PADDED_STRIDE_Z = PADDED_STRIDE_Y * PADDED_STRIDE_Y;
+
+		static constexpr int get_index(const int x, const int y, const int z) { return (z << (BIT_SIZE * 2)) | (y << BIT_SIZE) | x; }
+		static constexpr int get_padded_index(const int x, const int y, const int z) { return (z + 1) * PADDED_STRIDE_Z + (y + 1) * PADDED_STRIDE_Y + x + 1; }
+	};
+
+	// calls function with the ChunkLayout matching a runtime chunk size
+	template<typename Function>
+	decltype(auto) dispatch_chunk_size(const int chunkSize, Function&& function)
+	{
+		switch (chunkSize)
+		{
+			case 16: return function(ChunkLayout<16>());
+			case 32: return function(ChunkLayout<32>());
+			case 64: return function(ChunkLayout<64>());
+			default: LOG_ASSERT(false, "Chunk size must be 16, 32 or 64");
+		}
+
+		return function(ChunkLayout<16>());
+	}
+}
@@ -0,0 +1,264 @@
+#include "chunk_lod.h"
+#include "engine/core/logger/log.h"
+
+#include <algorithm>
+
+namespace Moxel
+{
+	// every voxel of the neighbour's touching layer under the apron cell at (a, b) is solid,
+	// a and b are the cell coordinates along the face's width and height axes
+	static bool is_patch_solid(const Chunk& neighbor, const Side side, const int a, const int b, const int scale)
+	{
+		const int last = neighbor.get_chunk_size() - 1;
+		const uint64_t cellMask = (1ull << scale) - 1;
+
+		switch (side)
+		{
+			case Side::LEFT:
+			case Side::RIGHT:
+			{
+				// width along y, height along z, one bit of every row
+				const int bit = side == Side::LEFT ? last : 0;
+				for (int z = b * scale; z < (b + 1) * scale; ++z)
+				{
+					for (int y = a * scale; y < (a + 1) * scale; ++y)
+					{
+						if (((neighbor.get_row(y, z) >> bit) & 1) == 0)
+							return false;
+					}
+				}
+
+				return true;
+			}
+			case Side::DOWN:
+			case Side::UP:
+			{
+				// width along z, height along x, one row per z
+				const int y = side == Side::DOWN ? last : 0;
+				for (int z = a * scale; z < (a + 1) * scale; ++z)
+				{
+					if (((neighbor.get_row(y, z) >> (b * scale)) & cellMask) != cellMask)
+						return false;
+				}
+
+				return true;
+			}
+			case Side::BACK:
+			case Side::FRONT:
+			{
+				// width along x, height along y, one row per y
+				const int z = side == Side::BACK ? last : 0;
+				for (int y = b * scale; y < (b + 1) * scale; ++y)
+				{
+					if (((neighbor.get_row(y, z) >> (a * scale)) & cellMask) != cellMask)
+						return false;
+				}
+
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	// solid voxels of every cell in one row, cell x is the scale bits at x * scale.
+	// the first steps of a swar popcount leave exactly these field sums
+	static uint64_t count_row_cells(uint64_t row, const int scale)
+	{
+		row -= (row >> 1) & 0x5555555555555555ull;
+		if (scale == 2)
+			return row;
+
+		row = (row & 0x3333333333333333ull) + ((row >> 2) & 0x3333333333333333ull);
+		if (scale == 4)
+			return row;
+
+		return (row + (row >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+	}
+
+	void ChunkLodGrid::build(const Chunk& chunk, const ChunkNeighbors& neighbors, const int lod, const LodRule rule)
+	{
+		const int chunkSize = chunk.get_chunk_size();
+		LOG_ASSERT((lod > 0 && lod <= MAX_LOD_LEVELS), "Lod level out of range");
+
+		m_scale = 1 << lod;
+		m_size = chunkSize >> lod;
+		m_stride = m_size + 2;
+
+		m_cells.assign(static_cast<size_t>(m_stride) * m_stride * m_stride, AIR_BLOCK);
+		m_counts.assign(static_cast<size_t>(m_size) * m_size * m_size, 0);
+
+		// solid voxels per cell, summed from the occupancy rows
+		const int cellVoxels = m_scale * m_scale * m_scale;
+		if (const auto* storage = chunk.get_storage(); storage != nullptr)
+		{
+			const uint64_t cellMask = (1ull << m_scale) - 1;
+			for (int z = 0; z < chunkSize; ++z)
+			{
+				for (int y = 0; y < chunkSize; ++y)
+				{
+					const uint64_t row = storage->get_row(y, z);
+					if (row == 0)
+						continue;
+
+					const uint64_t cells = count_row_cells(row, m_scale);
+					auto* counts = &m_counts[((z >> lod) * m_size + (y >> lod)) * m_size];
+					for (int x = 0; x < m_size; ++x)
+					{
+						counts[x] += static_cast<uint16_t>((cells >> (x * m_scale)) & cellMask);
+					}
+				}
+			}
+		}
+		else if (chunk.is_full())
+		{
+			std::fill(m_counts.begin(), m_counts.end(), static_cast<uint16_t>(cellVoxels));
+		}
+
+		// occupancy only chunks are a single material, palette chunks show their top voxel
+		const BlockId material = chunk.is_uniform() ? chunk.get_uniform_block() : DEFAULT_BLOCK;
+		const bool hasMaterials = chunk.get_materials() != nullptr;
+
+		const int last = m_size - 1;
+		for (int z = 0; z < m_size; ++z)
+		{
+			for (int y = 0; y < m_size; ++y)
+			{
+				for (int x = 0; x < m_size; ++x)
+				{
+					const int count = m_counts[(z * m_size + y) * m_size + x];
+					if (count == 0)
+						continue;
+
+					// border cells cover every solid voxel a neighbour culled its faces against
+					const bool isBorder = x == 0 || y == 0 || z == 0 || x == last || y == last || z == last;
+					if (rule == LodRule::MAJORITY && isBorder == false && count * 2 < cellVoxels)
+						continue;
+
+					auto block = material;
+					if (hasMaterials)
+					{
+						block = AIR_BLOCK;
+						for (int voxelY = (y + 1) * m_scale - 1; voxelY >= y * m_scale && block == AIR_BLOCK; --voxelY)
+						{
+							for (int voxelZ = z * m_scale; voxelZ < (z + 1) * m_scale && block == AIR_BLOCK; ++voxelZ)
+							{
+								for (int voxelX = x * m_scale; voxelX < (x + 1) * m_scale && block == AIR_BLOCK; ++voxelX)
+								{
+									block = chunk.get_block_type(voxelZ * chunkSize * chunkSize + voxelY * chunkSize + voxelX);
+								}
+							}
+						}
+					}
+
+					m_cells[get_index(x, y, z)] = block;
+				}
+			}
+		}
+
+		build_apron(neighbors);
+	}
+
+	void ChunkLodGrid::build_apron(const ChunkNeighbors& neighbors)
+	{
+		const int outside = m_size;
+
+		for (int b = 0; b < m_size; ++b)
+		{
+			for (int a = 0; a < m_size; ++a)
+			{
+				if (is_patch_solid(*neighbors[static_cast<int>(Side::LEFT)], Side::LEFT, a, b, m_scale))
+					m_cells[get_index(-1, a, b)] = DEFAULT_BLOCK;
+				if (is_patch_solid(*neighbors[static_cast<int>(Side::RIGHT)], Side::RIGHT, a, b, m_scale))
+					m_cells[get_index(outside, a, b)] = DEFAULT_BLOCK;
+
+				if (is_patch_solid(*neighbors[static_cast<int>(Side::DOWN)], Side::DOWN, a, b, m_scale))
+					m_cells[get_index(b, -1, a)] = DEFAULT_BLOCK;
+				if (is_patch_solid(*neighbors[static_cast<int>(Side::UP)], Side::UP, a, b, m_scale))
+					m_cells[get_index(b, outside, a)] = DEFAULT_BLOCK;
+
+				if (is_patch_solid(*neighbors[static_cast<int>(Side::BACK)], Side::BACK, a, b, m_scale))
+					m_cells[get_index(a, b, -1)] = DEFAULT_BLOCK;
+				if (is_patch_solid(*neighbors[static_cast<int>(Side::FRONT)], Side::FRONT, a, b, m_scale))
+					m_cells[get_index(a, b, outside)] = DEFAULT_BLOCK;
+			}
+		}
+	}
+
+	void mesh_chunk_lod(const Chunk& chunk, const ChunkNeighbors& neighbors, const int lod, const LodRule rule, ChunkMeshArena& mesh)
+	{
+		thread_local auto grid = ChunkLodGrid();
+		grid.build(chunk, neighbors, lod, rule);
+
+		const int size = grid.get_size();
+		const int scale = grid.get_scale();
+
+		// [u][v] blocks of the visible faces in one slice, u along the face width axis
+		thread_local auto plane = std::vector<BlockId>();
+		plane.assign(static_cast<size_t>(size) * size, AIR_BLOCK);
+
+		for (int sideIndex = 0; sideIndex < 6; ++sideIndex)
+		{
+			const auto side = static_cast<Side>(sideIndex);
+			const int axis = get_side_axis(side);
+			const int uAxis = (axis + 1) % 3;
+			const int vAxis = (axis + 2) % 3;
+			const bool isPositive = side == Side::FRONT || side == Side::RIGHT || side == Side::UP;
+
+			mesh.begin_faces(side, 0);
+
+			const int uStride = grid.get_stride(uAxis);
+			const int vStride = grid.get_stride(vAxis);
+			const int facing = isPositive ? grid.get_stride(axis) : -grid.get_stride(axis);
+
+			for (int depth = 0; depth < size; ++depth)
+			{
+				const BlockId* slice = grid.get_cells() + grid.get_index(0, 0, 0) + depth * grid.get_stride(axis);
+				for (int u = 0; u < size; ++u)
+				{
+					const BlockId* cells = slice + u * uStride;
+					for (int v = 0; v < size; ++v)
+					{
+						const BlockId* cell = cells + v * vStride;
+						plane[u * size + v] = cell[facing] == AIR_BLOCK ? *cell : AIR_BLOCK;
+					}
+				}
+
+				// runs of one block along v, grown along u while the next row repeats them
+				mesh.reserve_faces(static_cast<size_t>(size) * size);
+				for (int u = 0; u < size; ++u)
+				{
+					for (int v = 0; v < size; ++v)
+					{
+						const auto block = plane[u * size + v];
+						if (block == AIR_BLOCK)
+							continue;
+
+						int length = 1;
+						while (v + length < size && plane[u * size + v + length] == block)
+							length++;
+
+						int width = 1;
+						while (u + width < size && std::all_of(&plane[(u + width) * size + v], &plane[(u + width) * size + v + length], [block](const BlockId other) { return other == block; }))
+							width++;
+
+						for (int row = u; row < u + width; ++row)
+						{
+							std::fill_n(&plane[row * size + v], length, AIR_BLOCK);
+						}
+
+						// positive faces sit on the far voxel of their cell
+						auto origin = glm::ivec3();
+						origin[axis] = depth * scale + (isPositive ? scale - 1 : 0);
+						origin[uAxis] = u * scale;
+						origin[vAxis] = v * scale;
+
+						mesh.push_face(VoxelFace(origin.x, origin.y, origin.z, width * scale, length * scale, side, block));
+					}
+				}
+			}
+
+			mesh.end_faces(side, 0);
+		}
+	}
+}
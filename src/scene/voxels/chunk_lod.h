@@ -0,0 +1,49 @@
+#pragma once
+
+#include "chunk.h"
+#include "chunk_mesher.h"
+#include "chunk_snapshot.h"
+
+#include <vector>
+
+namespace Moxel
+{
+	// how a cube of 2^lod voxels collapses into one cell of a downsampled grid
+	enum class LodRule
+	{
+		ANY_SOLID, // solid if any voxel is, surfaces only grow
+		MAJORITY // solid if at least half of the voxels are
+	};
+
+	// chunk occupancy at 1 / 2^lod resolution with a one cell apron, cells hold the block
+	// seen from above or AIR_BLOCK. border cells always use ANY_SOLID and apron cells are
+	// solid only where the neighbour's whole touching patch is, so faces between chunks
+	// meshed at different levels are emitted on both sides and no cracks open between them
+	class ChunkLodGrid
+	{
+	public:
+		void build(const Chunk& chunk, const ChunkNeighbors& neighbors, int lod, LodRule rule);
+
+		// x, y, z are in cells and may be in [-1, size]
+		BlockId get(const int x, const int y, const int z) const { return m_cells[get_index(x, y, z)]; }
+		int get_index(const int x, const int y, const int z) const { return ((z + 1) * m_stride + y + 1) * m_stride + x + 1; }
+
+		const BlockId* get_cells() const { return m_cells.data(); }
+		int get_stride(const int axis) const { return axis == 0 ? 1 : axis == 1 ? m_stride : m_stride * m_stride; }
+		int get_size() const { return m_size; }
+		int get_scale() const { return m_scale; }
+	private:
+		void build_apron(const ChunkNeighbors& neighbors);
+
+		int m_size = 0;
+		int m_scale = 1;
+		int m_stride = 0;
+
+		std::vector<BlockId> m_cells; // (size + 2)^3
+		std::vector<uint16_t> m_counts; // solid voxels per cell, size^3
+	};
+
+	// greedy mesh of the chunk downsampled 2^lod times, faces of equal blocks are merged.
+	// lod meshes are always rebuilt whole, so every side keeps its faces in section 0
+	void mesh_chunk_lod(const Chunk& chunk, const ChunkNeighbors& neighbors, int lod, LodRule rule, ChunkMeshArena& mesh);
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "render_quad.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <vector>
+
+namespace Moxel
+{
+	// meshes are cut into horizontal sections of this many voxel rows, an edit only
+	// remeshes the sections it touches and greedy quads never cross a section boundary
+	constexpr int MESH_SECTION_DEPTH = 4;
+	constexpr int MAX_MESH_SECTIONS = 64 / MESH_SECTION_DEPTH;
+	constexpr uint32_t ALL_MESH_SECTIONS = ~0u;
+
+	constexpr int MAX_LOD_LEVELS = 3; // distant chunks are meshed 2x, 4x or 8x downsampled
+
+	inline int get_mesh_section_count(const int chunkSize) { return chunkSize / MESH_SECTION_DEPTH; }
+	inline uint32_t get_mesh_section_bit(const int y) { return 1u << (y / MESH_SECTION_DEPTH); }
+
+	// voxel rows from the lowest to the highest section in the mask
+	inline int get_mesh_sections_begin(const uint32_t sections) { return std::countr_zero(sections) * MESH_SECTION_DEPTH; }
+	inline int get_mesh_sections_end(const uint32_t sections) { return std::bit_width(sections) * MESH_SECTION_DEPTH; }
+
+	// sections whose faces can change when the voxel at row y does
+	inline uint32_t get_edit_sections(const int y, const int chunkSize)
+	{
+		return get_mesh_section_bit(std::max(y - 1, 0)) | get_mesh_section_bit(y) | get_mesh_section_bit(std::min(y + 1, chunkSize - 1));
+	}
+
+	// faces of one chunk grouped by side, then by section within a side, so every
+	// side is one contiguous range the renderer can skip and every (side, section)
+	// range can be replaced on its own
+	struct ChunkMeshData
+	{
+		std::vector<VoxelFace> Faces;
+		std::array<uint32_t, 6 * MAX_MESH_SECTIONS + 1> Offsets = {};
+		int Lod = 0; // faces come from a grid downsampled 2^Lod times
+
+		static int get_range(const Side side, const int section) { return static_cast<int>(side) * MAX_MESH_SECTIONS + section; }
+
+		uint32_t get_faces_begin(const Side side, const int section) const { return Offsets[get_range(side, section)]; }
+		uint32_t get_faces_end(const Side side, const int section) const { return Offsets[get_range(side, section) + 1]; }
+
+		uint32_t get_side_begin(const Side side) const { return Offsets[get_range(side, 0)]; }
+		uint32_t get_side_end(const Side side) const { return Offsets[get_range(side, 0) + MAX_MESH_SECTIONS]; }
+	};
+}
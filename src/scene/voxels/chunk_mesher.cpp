@@ -0,0 +1,233 @@
+#include "chunk_mesher.h"
+#include "chunk_face_masks.h"
+
+#include <algorithm>
+#include <bit>
+
+namespace Moxel
+{
+	static constexpr size_t MIN_ARENA_FACES = 1024;
+
+	void ChunkMeshArena::grow(const size_t faces)
+	{
+		m_faceCapacity = std::max({ faces, m_faceCapacity * 2, MIN_ARENA_FACES });
+
+		m_faces.resize(m_faceCapacity);
+	}
+
+	void ChunkMeshArena::write_mesh(ChunkMeshData& data, const ChunkMeshData& previous, const uint32_t sections, const int sectionCount) const
+	{
+		data.Faces.clear();
+		for (int side = 0; side < 6; ++side)
+		{
+			for (int section = 0; section < MAX_MESH_SECTIONS; ++section)
+			{
+				const int range = ChunkMeshData::get_range(static_cast<Side>(side), section);
+				data.Offsets[range] = static_cast<uint32_t>(data.Faces.size());
+
+				if (section >= sectionCount)
+					continue;
+
+				if (sections & (1u << section))
+				{
+					data.Faces.insert(data.Faces.end(), m_faces.begin() + m_rangeBegin[range], m_faces.begin() + m_rangeEnd[range]);
+				}
+				else
+				{
+					const auto first = previous.Faces.begin();
+					data.Faces.insert(data.Faces.end(), first + previous.Offsets[range], first + previous.Offsets[range + 1]);
+				}
+			}
+		}
+
+		data.Offsets.back() = static_cast<uint32_t>(data.Faces.size());
+	}
+
+	template<int Size>
+	void ChunkMesher<Size>::generate_faces(const Chunk& chunk, const ChunkNeighbors& neighbors, ChunkMeshArena& mesh, uint32_t sections)
+	{
+		sections &= (1u << SECTION_COUNT) - 1;
+		if (sections == 0)
+			return;
+
+		thread_local auto masks = ChunkFaceMasks(Size);
+		masks.build(chunk, neighbors, get_mesh_sections_begin(sections), get_mesh_sections_end(sections));
+
+		// occupancy only chunks are a single material
+		const auto* materials = chunk.get_materials();
+		const BlockId material = chunk.is_uniform() ? chunk.get_uniform_block() : DEFAULT_BLOCK;
+
+		for (uint32_t remaining = sections; remaining != 0; remaining &= remaining - 1)
+		{
+			const int section = std::countr_zero(remaining);
+			const int yBegin = section * MESH_SECTION_DEPTH;
+
+			for (int side = 0; side < 6; ++side)
+			{
+				mesh.begin_faces(static_cast<Side>(side), section);
+
+				const uint64_t* faces = masks.get_masks(static_cast<Side>(side));
+				for (int z = 0; z < Size; ++z)
+				{
+					for (int y = yBegin; y < yBegin + MESH_SECTION_DEPTH; ++y)
+					{
+						const uint64_t row = faces[z * Size + y];
+						if (row == 0)
+							continue;
+
+						mesh.reserve_faces(std::popcount(row));
+
+						for (uint64_t bits = row; bits != 0; bits &= bits - 1)
+						{
+							const int x = std::countr_zero(bits);
+							const auto block = materials != nullptr ? materials->get(Layout::get_index(x, y, z)) : material;
+
+							mesh.push_face(VoxelFace(x, y, z, 1, 1, static_cast<Side>(side), block));
+						}
+					}
+				}
+
+				mesh.end_faces(static_cast<Side>(side), section);
+			}
+		}
+	}
+
+	template<int Size>
+	void ChunkMesher<Size>::generate_greedy(const Chunk& chunk, const ChunkNeighbors& neighbors, ChunkMeshArena& mesh, uint32_t sections)
+	{
+		sections &= (1u << SECTION_COUNT) - 1;
+		if (sections == 0)
+			return;
+
+		thread_local auto masks = ChunkFaceMasks(Size);
+		masks.build(chunk, neighbors, get_mesh_sections_begin(sections), get_mesh_sections_end(sections));
+
+		// merging ignores materials, so palette chunks take the per-face path in mesh_chunk
+		const BlockId material = chunk.is_uniform() ? chunk.get_uniform_block() : DEFAULT_BLOCK;
+
+		// [depth][u] with bits over v, merge_plane consumes every bit it visits so
+		// the plane is all zero between uses and only the visited range is written
+		thread_local auto plane = std::vector<uint64_t>(Size * Size);
+
+		// merges each plane row into runs along v, then grows every run along u
+		const auto merge_plane = [&mesh](uint64_t* plane, const int depthBegin, const int depthEnd, const int uBegin, const int uEnd, const auto& make_face)
+		{
+			for (int depth = depthBegin; depth < depthEnd; ++depth)
+			{
+				auto* rows = &plane[depth * Size];
+				for (int u = uBegin; u < uEnd; ++u)
+				{
+					// runs in a row are separated by gaps, at most Size / 2 of them
+					mesh.reserve_faces(Size / 2);
+
+					while (rows[u] != 0)
+					{
+						const int v = std::countr_zero(rows[u]);
+						const int length = std::countr_one(rows[u] >> v);
+						const uint64_t run = (length == 64 ? ~0ull : (1ull << length) - 1) << v;
+
+						int width = 1;
+						rows[u] &= ~run;
+						while (u + width < uEnd && (rows[u + width] & run) == run)
+						{
+							rows[u + width] &= ~run;
+							width++;
+						}
+
+						mesh.push_face(make_face(depth, u, v, width, length));
+					}
+				}
+			}
+		};
+
+		for (uint32_t remaining = sections; remaining != 0; remaining &= remaining - 1)
+		{
+			const int section = std::countr_zero(remaining);
+			const int yBegin = section * MESH_SECTION_DEPTH;
+			const int yEnd = yBegin + MESH_SECTION_DEPTH;
+
+			for (const auto side: { Side::LEFT, Side::RIGHT })
+			{
+				mesh.begin_faces(side, section);
+
+				// mask rows run along x, the plane is [x][z] with bits over the section's y
+				const uint64_t* faces = masks.get_masks(side);
+				for (int z = 0; z < Size; ++z)
+				{
+					for (int y = yBegin; y < yEnd; ++y)
+					{
+						for (uint64_t bits = faces[z * Size + y]; bits != 0; bits &= bits - 1)
+						{
+							plane[std::countr_zero(bits) * Size + z] |= 1ull << y;
+						}
+					}
+				}
+
+				merge_plane(plane.data(), 0, Size, 0, Size, [side, material](const int x, const int z, const int y, const int width, const int length)
+				{
+					return VoxelFace(x, y, z, length, width, side, material);
+				});
+
+				mesh.end_faces(side, section);
+			}
+
+			for (const auto side: { Side::DOWN, Side::UP })
+			{
+				mesh.begin_faces(side, section);
+
+				// plane is [y][z] with bits over x, a transposed copy of the mask rows
+				const uint64_t* faces = masks.get_masks(side);
+				for (int z = 0; z < Size; ++z)
+				{
+					for (int y = yBegin; y < yEnd; ++y)
+					{
+						plane[y * Size + z] = faces[z * Size + y];
+					}
+				}
+
+				merge_plane(plane.data(), yBegin, yEnd, 0, Size, [side, material](const int y, const int z, const int x, const int width, const int length)
+				{
+					return VoxelFace(x, y, z, width, length, side, material);
+				});
+
+				mesh.end_faces(side, section);
+			}
+
+			for (const auto side: { Side::BACK, Side::FRONT })
+			{
+				mesh.begin_faces(side, section);
+
+				// plane is [z][y] with bits over x, the mask rows as they are
+				const uint64_t* faces = masks.get_masks(side);
+				for (int z = 0; z < Size; ++z)
+				{
+					std::copy(faces + z * Size + yBegin, faces + z * Size + yEnd, plane.begin() + z * Size + yBegin);
+				}
+
+				merge_plane(plane.data(), 0, Size, yBegin, yEnd, [side, material](const int z, const int y, const int x, const int width, const int length)
+				{
+					return VoxelFace(x, y, z, length, width, side, material);
+				});
+
+				mesh.end_faces(side, section);
+			}
+		}
+	}
+
+	template class ChunkMesher<16>;
+	template class ChunkMesher<32>;
+	template class ChunkMesher<64>;
+
+	void mesh_chunk(const MeshingMode mode, const Chunk& chunk, const ChunkNeighbors& neighbors, ChunkMeshArena& mesh, const uint32_t sections)
+	{
+		dispatch_chunk_size(chunk.get_chunk_size(), [&](auto layout)
+		{
+			using Mesher = ChunkMesher<decltype(layout)::SIZE>;
+
+			if (mode == MeshingMode::GREEDY && chunk.get_materials() == nullptr)
+				Mesher::generate_greedy(chunk, neighbors, mesh, sections);
+			else
+				Mesher::generate_faces(chunk, neighbors, mesh, sections);
+		});
+	}
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "chunk.h"
+#include "chunk_layout.h"
+#include "chunk_mesh_data.h"
+#include "chunk_snapshot.h"
+#include "render_quad.h"
+
+#include <vector>
+
+namespace Moxel
+{
+	enum class MeshingMode
+	{
+		PER_FACE, // one quad per exposed voxel face
+		GREEDY // coplanar faces merged into rectangles
+	};
+
+	// reusable mesher output, grows to the high water mark and is never shrunk,
+	// so meshing allocates nothing once a thread has seen its busiest chunk
+	class ChunkMeshArena
+	{
+	public:
+		void clear()
+		{
+			m_faceCount = 0;
+
+			// ranges a mesher skips stay empty
+			m_rangeBegin.fill(0);
+			m_rangeEnd.fill(0);
+		}
+
+		// room for count more faces, push_face does no bounds checks
+		void reserve_faces(const size_t count)
+		{
+			if (m_faceCount + count > m_faceCapacity)
+				grow(m_faceCount + count);
+		}
+
+		void push_face(const VoxelFace& face) { m_faces[m_faceCount++] = face; }
+
+		// meshers bracket the faces they emit for every side of every section
+		void begin_faces(const Side side, const int section) { m_rangeBegin[ChunkMeshData::get_range(side, section)] = static_cast<uint32_t>(m_faceCount); }
+		void end_faces(const Side side, const int section) { m_rangeEnd[ChunkMeshData::get_range(side, section)] = static_cast<uint32_t>(m_faceCount); }
+
+		// data gets the arena's faces for the sections in the mask and previous faces for the rest, sorted by side
+		void write_mesh(ChunkMeshData& data, const ChunkMeshData& previous, uint32_t sections, int sectionCount) const;
+
+		const VoxelFace* get_faces() const { return m_faces.data(); }
+
+		size_t get_face_count() const { return m_faceCount; }
+		bool empty() const { return m_faceCount == 0; }
+	private:
+		void grow(size_t faces);
+
+		std::vector<VoxelFace> m_faces;
+
+		size_t m_faceCount = 0;
+		size_t m_faceCapacity = 0;
+
+		std::array<uint32_t, 6 * MAX_MESH_SECTIONS> m_rangeBegin = {};
+		std::array<uint32_t, 6 * MAX_MESH_SECTIONS> m_rangeEnd = {};
+	};
+
+	// meshers specialized on the chunk size, explicitly instantiated for 16, 32 and 64
+	template<int Size>
+	class ChunkMesher
+	{
+	public:
+		using Layout = ChunkLayout<Size>;
+
+		static constexpr int SECTION_COUNT = Size / MESH_SECTION_DEPTH;
+
+		// both mesh only the sections set in the mask, in ascending order
+		static void generate_faces(const Chunk& chunk, const ChunkNeighbors& neighbors, ChunkMeshArena& mesh, uint32_t sections = ALL_MESH_SECTIONS);
+
+		// visible face planes from ChunkFaceMasks, rectangles grown with bit scans
+		static void generate_greedy(const Chunk& chunk, const ChunkNeighbors& neighbors, ChunkMeshArena& mesh, uint32_t sections = ALL_MESH_SECTIONS);
+	};
+
+	extern template class ChunkMesher<16>;
+	extern template class ChunkMesher<32>;
+	extern template class ChunkMesher<64>;
+
+	// picks the instantiation matching chunk.get_chunk_size(), appends to mesh
+	void mesh_chunk(MeshingMode mode, const Chunk& chunk, const ChunkNeighbors& neighbors, ChunkMeshArena& mesh, uint32_t sections = ALL_MESH_SECTIONS);
+}
@@ -0,0 +1,58 @@
+#include "chunk_snapshot.h"
+
+namespace Moxel
+{
+	PaddedChunkSnapshot::PaddedChunkSnapshot(const int chunkSize)
+	{
+		m_chunkSize = chunkSize;
+		m_strideY = chunkSize + 2;
+		m_strideZ = m_strideY * m_strideY;
+
+		m_voxels.resize(m_strideZ * m_strideY);
+	}
+
+	void PaddedChunkSnapshot::build(const Chunk& chunk, const ChunkNeighbors& neighbors)
+	{
+		const int chunkSize = m_chunkSize;
+		const int last = chunkSize - 1;
+
+		const auto& left = *neighbors[static_cast<int>(Side::LEFT)];
+		const auto& right = *neighbors[static_cast<int>(Side::RIGHT)];
+		const auto& down = *neighbors[static_cast<int>(Side::DOWN)];
+		const auto& up = *neighbors[static_cast<int>(Side::UP)];
+		const auto& back = *neighbors[static_cast<int>(Side::BACK)];
+		const auto& front = *neighbors[static_cast<int>(Side::FRONT)];
+
+		for (int z = 0; z < chunkSize; ++z)
+		{
+			for (int y = 0; y < chunkSize; ++y)
+			{
+				copy_row(y, z, chunk.get_row(y, z));
+
+				// x apron
+				m_voxels[get_index(-1, y, z)] = (left.get_row(y, z) >> last) & 1;
+				m_voxels[get_index(chunkSize, y, z)] = right.get_row(y, z) & 1;
+			}
+
+			// y apron
+			copy_row(-1, z, down.get_row(last, z));
+			copy_row(chunkSize, z, up.get_row(0, z));
+		}
+
+		// z apron
+		for (int y = 0; y < chunkSize; ++y)
+		{
+			copy_row(y, -1, back.get_row(y, last));
+			copy_row(y, chunkSize, front.get_row(y, 0));
+		}
+	}
+
+	void PaddedChunkSnapshot::copy_row(const int y, const int z, const uint64_t row)
+	{
+		auto* voxels = &m_voxels[get_index(0, y, z)];
+		for (int x = 0; x < m_chunkSize; ++x)
+		{
+			voxels[x] = (row >> x) & 1;
+		}
+	}
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "chunk.h"
+#include "render_quad.h"
+
+#include <array>
+#include <vector>
+
+namespace Moxel
+{
+	// neighbours are indexed by Side
+	using ChunkNeighbors = std::array<const Chunk*, 6>;
+
+	// chunk voxels plus one voxel apron from the six face neighbours copied
+	// into a flat (N + 2)^3 byte array, edges and corners of the apron stay empty
+	class PaddedChunkSnapshot
+	{
+	public:
+		PaddedChunkSnapshot(int chunkSize);
+
+		void build(const Chunk& chunk, const ChunkNeighbors& neighbors);
+
+		// x, y, z are chunk local and may be in [-1, N]
+		bool get(const int x, const int y, const int z) const { return m_voxels[get_index(x, y, z)]; }
+		int get_index(const int x, const int y, const int z) const { return (z + 1) * m_strideZ + (y + 1) * m_strideY + x + 1; }
+
+		const uint8_t* get_data() const { return m_voxels.data(); }
+		int get_stride_y() const { return m_strideY; }
+		int get_stride_z() const { return m_strideZ; }
+		int get_chunk_size() const { return m_chunkSize; }
+	private:
+		void copy_row(int y, int z, uint64_t row);
+
+		std::vector<uint8_t> m_voxels;
+
+		int m_chunkSize = 0;
+		int m_strideY = 0;
+		int m_strideZ = 0;
+	};
+}
@@ -0,0 +1,289 @@
+#include "chunk_storage.h"
+#include "engine/core/logger/log.h"
+
+#include <bit>
+#include <cstring>
+
+namespace Moxel
+{
+	ChunkBitStorage::ChunkBitStorage(const int chunkSize)
+	{
+		LOG_ASSERT((std::has_single_bit(static_cast<uint32_t>(chunkSize)) && chunkSize >= 8 && chunkSize <= 64), "Chunk size must be a power of two in [8, 64]");
+
+		m_chunkSize = chunkSize;
+		m_bitSize = std::countr_zero(static_cast<uint32_t>(chunkSize));
+		m_rowMask = static_cast<size_t>(chunkSize) == WORD_BITS ? ~0ull : (1ull << chunkSize) - 1;
+
+		m_wordCount = chunkSize * chunkSize * chunkSize / WORD_BITS;
+		allocate_words();
+	}
+
+	ChunkBitStorage::ChunkBitStorage(const ChunkBitStorage& other)
+	{
+		m_chunkSize = other.m_chunkSize;
+		m_bitSize = other.m_bitSize;
+		m_rowMask = other.m_rowMask;
+
+		m_wordCount = other.m_wordCount;
+		allocate_words();
+		memcpy(m_words.get(), other.m_words.get(), get_byte_size());
+	}
+
+	ChunkBitStorage& ChunkBitStorage::operator=(const ChunkBitStorage& other)
+	{
+		if (this == &other)
+			return *this;
+
+		m_chunkSize = other.m_chunkSize;
+		if (m_words == nullptr || m_wordCount != other.m_wordCount)
+		{
+			m_wordCount = other.m_wordCount;
+			allocate_words();
+		}
+
+		m_bitSize = other.m_bitSize;
+		m_rowMask = other.m_rowMask;
+		memcpy(m_words.get(), other.m_words.get(), get_byte_size());
+
+		return *this;
+	}
+
+	uint64_t ChunkBitStorage::get_row(const int y, const int z) const
+	{
+		const int start = get_index(0, y, z);
+
+		return (m_words[start >> 6] >> (start & 63)) & m_rowMask;
+	}
+
+	void ChunkBitStorage::set_row(const int y, const int z, const uint64_t bits)
+	{
+		const int start = get_index(0, y, z);
+		const int shift = start & 63;
+
+		auto& word = m_words[start >> 6];
+		word = (word & ~(m_rowMask << shift)) | ((bits & m_rowMask) << shift);
+	}
+
+	uint64_t ChunkBitStorage::get_column(const int x, const int z) const
+	{
+		uint64_t bits = 0;
+		for (int y = 0; y < m_chunkSize; ++y)
+		{
+			bits |= static_cast<uint64_t>(get(x, y, z)) << y;
+		}
+
+		return bits;
+	}
+
+	void ChunkBitStorage::set_column(const int x, const int z, const uint64_t bits)
+	{
+		for (int y = 0; y < m_chunkSize; ++y)
+		{
+			const int index = get_index(x, y, z);
+
+			if ((bits >> y) & 1)
+				set(index);
+			else
+				reset(index);
+		}
+	}
+
+	int ChunkBitStorage::count_slab(const int z) const
+	{
+		const auto* slab = get_slab(z);
+
+		int count = 0;
+		for (int i = 0; i < get_slab_word_count(); ++i)
+		{
+			count += std::popcount(slab[i]);
+		}
+
+		return count;
+	}
+
+	int ChunkBitStorage::count_solid() const
+	{
+		int count = 0;
+		for (int i = 0; i < m_wordCount; ++i)
+		{
+			count += std::popcount(m_words[i]);
+		}
+
+		return count;
+	}
+
+	bool ChunkBitStorage::is_empty() const
+	{
+		for (int i = 0; i < m_wordCount; ++i)
+		{
+			if (m_words[i] != 0)
+				return false;
+		}
+
+		return true;
+	}
+
+	bool ChunkBitStorage::is_full() const
+	{
+		for (int i = 0; i < m_wordCount; ++i)
+		{
+			if (m_words[i] != ~0ull)
+				return false;
+		}
+
+		return true;
+	}
+
+	void ChunkBitStorage::clear()
+	{
+		memset(m_words.get(), 0, get_byte_size());
+	}
+
+	void ChunkBitStorage::fill()
+	{
+		memset(m_words.get(), 0xFF, get_byte_size());
+	}
+
+	SlabPool& ChunkBitStorage::get_word_pool(const int chunkSize)
+	{
+		static SlabPool pools[] =
+		{
+			{ "Voxels 8^3", 8 * 8 * 8 / 8, ALIGNMENT },
+			{ "Voxels 16^3", 16 * 16 * 16 / 8, ALIGNMENT },
+			{ "Voxels 32^3", 32 * 32 * 32 / 8, ALIGNMENT },
+			{ "Voxels 64^3", 64 * 64 * 64 / 8, ALIGNMENT },
+		};
+
+		return pools[std::countr_zero(static_cast<uint32_t>(chunkSize)) - 3];
+	}
+
+	void ChunkBitStorage::allocate_words()
+	{
+		auto& pool = get_word_pool(m_chunkSize);
+
+		const auto words = static_cast<uint64_t*>(pool.allocate(get_byte_size()));
+		memset(words, 0, get_byte_size());
+
+		m_words = std::unique_ptr<uint64_t[], PoolDeleter>(words, PoolDeleter{ &pool });
+	}
+
+	//
+	// ChunkPaletteStorage
+	//
+
+	ChunkPaletteStorage::ChunkPaletteStorage(const int voxelCount, const BlockId fill)
+	{
+		m_voxelCount = voxelCount;
+		m_palette.push_back(fill);
+
+		resize_indices(0);
+	}
+
+	ChunkPaletteStorage ChunkPaletteStorage::from_occupancy(const ChunkBitStorage& occupancy, const BlockId solid)
+	{
+		auto storage = ChunkPaletteStorage(occupancy.get_word_count() * ChunkBitStorage::WORD_BITS);
+		storage.m_palette.push_back(solid);
+
+		// one bit indices share the occupancy layout, so words copy as they are
+		memcpy(storage.m_indices.data(), occupancy.get_words(), occupancy.get_byte_size());
+
+		return storage;
+	}
+
+	void ChunkPaletteStorage::set(const int index, const BlockId block)
+	{
+		uint32_t paletteIndex = 0;
+		while (paletteIndex < m_palette.size() && m_palette[paletteIndex] != block)
+		{
+			paletteIndex++;
+		}
+
+		if (paletteIndex == m_palette.size())
+		{
+			LOG_ASSERT((m_palette.size() < 1u << 16), "Chunk palette overflow");
+
+			m_palette.push_back(block);
+			if (m_palette.size() > 1ull << get_bits_per_index())
+				resize_indices(m_indexShift + 1);
+		}
+
+		write_index(index, paletteIndex);
+	}
+
+	void ChunkPaletteStorage::compact()
+	{
+		auto used = std::vector<bool>(m_palette.size());
+		for (int i = 0; i < m_voxelCount; ++i)
+		{
+			used[read_index(i)] = true;
+		}
+
+		// remap palette entries that are still referenced
+		auto remap = std::vector<uint32_t>(m_palette.size());
+		auto palette = std::vector<BlockId>();
+		for (uint32_t i = 0; i < m_palette.size(); ++i)
+		{
+			if (used[i] == false)
+				continue;
+
+			remap[i] = palette.size();
+			palette.push_back(m_palette[i]);
+		}
+
+		if (palette.size() == m_palette.size())
+			return;
+
+		auto indices = std::vector<uint32_t>(m_voxelCount);
+		for (int i = 0; i < m_voxelCount; ++i)
+		{
+			indices[i] = remap[read_index(i)];
+		}
+
+		int indexShift = 0;
+		while (palette.size() > 1ull << (1 << indexShift))
+		{
+			indexShift++;
+		}
+
+		m_palette = std::move(palette);
+		m_indexShift = indexShift;
+		m_indexMask = (1ull << get_bits_per_index()) - 1;
+		m_indices.assign((static_cast<size_t>(m_voxelCount) << m_indexShift) / ChunkBitStorage::WORD_BITS, 0);
+
+		for (int i = 0; i < m_voxelCount; ++i)
+		{
+			write_index(i, indices[i]);
+		}
+	}
+
+	void ChunkPaletteStorage::write_index(const int index, const uint32_t value)
+	{
+		const int bit = index << m_indexShift;
+		const int shift = bit & 63;
+
+		auto& word = m_indices[bit >> 6];
+		word = (word & ~(m_indexMask << shift)) | (static_cast<uint64_t>(value) << shift);
+	}
+
+	void ChunkPaletteStorage::resize_indices(const int indexShift)
+	{
+		auto indices = std::vector<uint32_t>();
+		if (m_indices.empty() == false)
+		{
+			indices.resize(m_voxelCount);
+			for (int i = 0; i < m_voxelCount; ++i)
+			{
+				indices[i] = read_index(i);
+			}
+		}
+
+		m_indexShift = indexShift;
+		m_indexMask = (1ull << get_bits_per_index()) - 1;
+		m_indices.assign((static_cast<size_t>(m_voxelCount) << m_indexShift) / ChunkBitStorage::WORD_BITS, 0);
+
+		for (int i = 0; i < static_cast<int>(indices.size()); ++i)
+		{
+			write_index(i, indices[i]);
+		}
+	}
+}
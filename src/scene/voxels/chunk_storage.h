@@ -0,0 +1,117 @@
+#pragma once
+
+#include "engine/core/slab_pool.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace Moxel
+{
+	using BlockId = uint16_t;
+
+	constexpr BlockId AIR_BLOCK = 0;
+	constexpr BlockId DEFAULT_BLOCK = 1;
+
+	// occupancy bits packed into 64-bit words, x runs inside a word,
+	// so a single X row is always a contiguous bit range of one word
+	class ChunkBitStorage
+	{
+	public:
+		static constexpr size_t WORD_BITS = 64;
+		static constexpr size_t ALIGNMENT = 64;
+
+		ChunkBitStorage(int chunkSize);
+		ChunkBitStorage(const ChunkBitStorage& other);
+		ChunkBitStorage& operator=(const ChunkBitStorage& other);
+		ChunkBitStorage(ChunkBitStorage&& other) noexcept = default;
+		ChunkBitStorage& operator=(ChunkBitStorage&& other) noexcept = default;
+		~ChunkBitStorage() = default;
+
+		bool get(const int index) const { return (m_words[index >> 6] >> (index & 63)) & 1; }
+		void set(const int index) { m_words[index >> 6] |= 1ull << (index & 63); }
+		void reset(const int index) { m_words[index >> 6] &= ~(1ull << (index & 63)); }
+
+		bool get(const int x, const int y, const int z) const { return get(get_index(x, y, z)); }
+		int get_index(const int x, const int y, const int z) const { return (z << m_bitSize << m_bitSize) | (y << m_bitSize) | x; }
+
+		uint64_t get_row(int y, int z) const;
+		void set_row(int y, int z, uint64_t bits);
+
+		uint64_t get_column(int x, int z) const;
+		void set_column(int x, int z, uint64_t bits);
+
+		const uint64_t* get_slab(const int z) const { return m_words.get() + z * get_slab_word_count(); }
+		uint64_t* get_slab(const int z) { return m_words.get() + z * get_slab_word_count(); }
+		int get_slab_word_count() const { return m_chunkSize * m_chunkSize / WORD_BITS; }
+		int count_slab(int z) const;
+
+		const uint64_t* get_words() const { return m_words.get(); }
+		uint64_t* get_words() { return m_words.get(); }
+		int get_word_count() const { return m_wordCount; }
+		size_t get_byte_size() const { return m_wordCount * sizeof(uint64_t); }
+
+		int get_chunk_size() const { return m_chunkSize; }
+		uint64_t get_row_mask() const { return m_rowMask; }
+
+		int count_solid() const;
+		bool is_empty() const;
+		bool is_full() const;
+
+		void clear();
+		void fill();
+	private:
+		struct PoolDeleter
+		{
+			SlabPool* Pool;
+
+			void operator()(uint64_t* words) const { Pool->deallocate(words); }
+		};
+
+		static SlabPool& get_word_pool(int chunkSize);
+		void allocate_words();
+
+		std::unique_ptr<uint64_t[], PoolDeleter> m_words;
+		int m_wordCount = 0;
+
+		int m_chunkSize = 0;
+		int m_bitSize = 0;
+		uint64_t m_rowMask = 0;
+	};
+
+	// per-chunk palette of block ids with bit-packed indices into it,
+	// index width grows 1 -> 2 -> 4 -> 8 -> 16 bits as the palette fills up
+	class ChunkPaletteStorage
+	{
+	public:
+		ChunkPaletteStorage(int voxelCount, BlockId fill = AIR_BLOCK);
+
+		static ChunkPaletteStorage from_occupancy(const ChunkBitStorage& occupancy, BlockId solid = DEFAULT_BLOCK);
+
+		BlockId get(const int index) const { return m_palette[read_index(index)]; }
+		void set(int index, BlockId block);
+
+		void compact();
+
+		const std::vector<BlockId>& get_palette() const { return m_palette; }
+		int get_bits_per_index() const { return 1 << m_indexShift; }
+		size_t get_byte_size() const { return m_indices.size() * sizeof(uint64_t) + m_palette.size() * sizeof(BlockId); }
+	private:
+		uint32_t read_index(const int index) const
+		{
+			const int bit = index << m_indexShift;
+
+			return (m_indices[bit >> 6] >> (bit & 63)) & m_indexMask;
+		}
+
+		void write_index(int index, uint32_t value);
+		void resize_indices(int indexShift);
+
+		std::vector<BlockId> m_palette;
+		std::vector<uint64_t> m_indices;
+
+		int m_voxelCount = 0;
+		int m_indexShift = 0; // log2 of bits per index
+		uint64_t m_indexMask = 1;
+	};
+}
@@ -0,0 +1,165 @@
+#include "chunk_summary.h"
+
+#include <algorithm>
+#include <bit>
+
+namespace Moxel
+{
+	void ChunkSummary::build_uniform(const int chunkSize, const bool isSolid)
+	{
+		const int faceArea = chunkSize * chunkSize;
+
+		m_chunkSize = chunkSize;
+		m_solidCount = isSolid ? faceArea * chunkSize : 0;
+		m_faceCounts.fill(isSolid ? faceArea : 0);
+		m_columns.clear();
+	}
+
+	void ChunkSummary::build(const ChunkBitStorage& blocks)
+	{
+		const int chunkSize = blocks.get_chunk_size();
+		const int last = chunkSize - 1;
+
+		m_chunkSize = chunkSize;
+		m_solidCount = 0;
+		m_faceCounts.fill(0);
+		m_columns.assign(chunkSize * chunkSize, ColumnRange());
+
+		for (int z = 0; z < chunkSize; ++z)
+		{
+			auto* columns = &m_columns[z * chunkSize];
+
+			// first row from the bottom that reaches a column sets its bottom
+			uint64_t seen = 0;
+			for (int y = 0; y < chunkSize; ++y)
+			{
+				const uint64_t row = blocks.get_row(y, z);
+				const int solid = std::popcount(row);
+
+				m_solidCount += solid;
+				m_faceCounts[static_cast<int>(Side::LEFT)] += row & 1;
+				m_faceCounts[static_cast<int>(Side::RIGHT)] += (row >> last) & 1;
+
+				if (y == 0)
+					m_faceCounts[static_cast<int>(Side::DOWN)] += solid;
+				if (y == last)
+					m_faceCounts[static_cast<int>(Side::UP)] += solid;
+				if (z == 0)
+					m_faceCounts[static_cast<int>(Side::BACK)] += solid;
+				if (z == last)
+					m_faceCounts[static_cast<int>(Side::FRONT)] += solid;
+
+				for (uint64_t fresh = row & ~seen; fresh != 0; fresh &= fresh - 1)
+				{
+					columns[std::countr_zero(fresh)].Bottom = static_cast<uint8_t>(y);
+				}
+
+				seen |= row;
+			}
+
+			// and the same from the top
+			seen = 0;
+			for (int y = last; y >= 0; --y)
+			{
+				const uint64_t row = blocks.get_row(y, z);
+				for (uint64_t fresh = row & ~seen; fresh != 0; fresh &= fresh - 1)
+				{
+					columns[std::countr_zero(fresh)].Top = static_cast<uint8_t>(y);
+				}
+
+				seen |= row;
+			}
+		}
+	}
+
+	void ChunkSummary::update_voxel(const ChunkBitStorage& blocks, const int x, const int y, const int z, const bool isSolid)
+	{
+		const int last = m_chunkSize - 1;
+		const int delta = isSolid ? 1 : -1;
+
+		ensure_columns();
+
+		m_solidCount += delta;
+		if (x == 0)
+			m_faceCounts[static_cast<int>(Side::LEFT)] += delta;
+		if (x == last)
+			m_faceCounts[static_cast<int>(Side::RIGHT)] += delta;
+		if (y == 0)
+			m_faceCounts[static_cast<int>(Side::DOWN)] += delta;
+		if (y == last)
+			m_faceCounts[static_cast<int>(Side::UP)] += delta;
+		if (z == 0)
+			m_faceCounts[static_cast<int>(Side::BACK)] += delta;
+		if (z == last)
+			m_faceCounts[static_cast<int>(Side::FRONT)] += delta;
+
+		auto& column = m_columns[z * m_chunkSize + x];
+		if (isSolid)
+		{
+			if (column.is_empty())
+			{
+				column.Bottom = static_cast<uint8_t>(y);
+				column.Top = static_cast<uint8_t>(y);
+			}
+			else
+			{
+				column.Bottom = std::min(column.Bottom, static_cast<uint8_t>(y));
+				column.Top = std::max(column.Top, static_cast<uint8_t>(y));
+			}
+		}
+		else if (y == column.Bottom || y == column.Top)
+		{
+			// only removing an end voxel moves the range
+			update_column(blocks, x, z);
+		}
+	}
+
+	uint8_t ChunkSummary::get_face_mask() const
+	{
+		const int faceArea = m_chunkSize * m_chunkSize;
+
+		uint8_t mask = 0;
+		for (int side = 0; side < 6; ++side)
+		{
+			if (m_faceCounts[side] == faceArea)
+				mask |= 1 << side;
+		}
+
+		return mask;
+	}
+
+	ColumnRange ChunkSummary::get_column(const int x, const int z) const
+	{
+		if (m_columns.empty() == false)
+			return m_columns[z * m_chunkSize + x];
+
+		// uniform chunk, every column is either empty or spans the chunk
+		if (m_solidCount == 0)
+			return ColumnRange();
+
+		return { 0, static_cast<uint8_t>(m_chunkSize - 1) };
+	}
+
+	void ChunkSummary::ensure_columns()
+	{
+		if (m_columns.empty() == false)
+			return;
+
+		m_columns.assign(m_chunkSize * m_chunkSize, get_column(0, 0));
+	}
+
+	void ChunkSummary::update_column(const ChunkBitStorage& blocks, const int x, const int z)
+	{
+		const uint64_t bits = blocks.get_column(x, z);
+
+		auto& column = m_columns[z * m_chunkSize + x];
+		if (bits == 0)
+		{
+			column = ColumnRange();
+			return;
+		}
+
+		column.Bottom = static_cast<uint8_t>(std::countr_zero(bits));
+		column.Top = static_cast<uint8_t>(63 - std::countl_zero(bits));
+	}
+}
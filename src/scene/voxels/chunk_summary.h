@@ -0,0 +1,50 @@
+#pragma once
+
+#include "chunk_storage.h"
+#include "render_quad.h"
+
+#include <array>
+#include <vector>
+
+namespace Moxel
+{
+	// inclusive y range of the solid voxels in one column
+	struct ColumnRange
+	{
+		uint8_t Bottom = 1;
+		uint8_t Top = 0;
+
+		bool is_empty() const { return Bottom > Top; }
+	};
+
+	// occupancy facts kept in step with every chunk write, so callers can reason
+	// about geometry without walking voxels
+	class ChunkSummary
+	{
+	public:
+		void build_uniform(int chunkSize, bool isSolid);
+		void build(const ChunkBitStorage& blocks);
+
+		// called after a single voxel flipped to isSolid
+		void update_voxel(const ChunkBitStorage& blocks, int x, int y, int z, bool isSolid);
+
+		uint32_t get_solid_count() const { return m_solidCount; }
+		bool is_empty() const { return m_solidCount == 0; }
+		bool is_full() const { return m_solidCount == static_cast<uint32_t>(m_chunkSize * m_chunkSize * m_chunkSize); }
+
+		// bit per Side, set when every voxel on that face is solid
+		uint8_t get_face_mask() const;
+		bool is_face_solid(const Side side) const { return (get_face_mask() >> static_cast<int>(side)) & 1; }
+
+		ColumnRange get_column(int x, int z) const;
+	private:
+		void ensure_columns();
+		void update_column(const ChunkBitStorage& blocks, int x, int z);
+
+		int m_chunkSize = 0;
+		uint32_t m_solidCount = 0;
+		std::array<uint16_t, 6> m_faceCounts = {}; // solid voxels per face, indexed by Side
+
+		std::vector<ColumnRange> m_columns; // x + z * N, left empty while the chunk is uniform
+	};
+}
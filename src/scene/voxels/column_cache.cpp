@@ -0,0 +1,145 @@
+#include "column_cache.h"
+
+namespace Moxel
+{
+	ColumnCache::ColumnCache(const size_t capacity, const int chunkSize)
+	{
+		m_capacity = capacity;
+		m_fieldSize = static_cast<size_t>(chunkSize) * chunkSize;
+	}
+
+	ColumnCache::Lease ColumnCache::acquire(const ChunkPosition column)
+	{
+		std::lock_guard lock(m_mutex);
+		if (m_capacity == 0)
+		{
+			m_stats.Misses++;
+			return Lease();
+		}
+
+		if (m_slots.empty())
+			allocate_slots();
+
+		if (const auto cached = m_entries.find(column); cached != nullptr)
+		{
+			m_slots[*cached].Pins++;
+			unlink(*cached);
+			push_front(*cached);
+
+			m_stats.Hits++;
+			return { *cached, true };
+		}
+
+		m_stats.Misses++;
+
+		// pinned slots are still being read, the next older one is taken instead
+		for (uint32_t slot = m_tail; slot != NO_SLOT; slot = m_slots[slot].Previous)
+		{
+			auto& entry = m_slots[slot];
+			if (entry.Pins > 0)
+				continue;
+
+			if (entry.IsCached)
+			{
+				m_entries.erase(entry.Column);
+				entry.IsCached = false;
+				m_stats.Entries--;
+			}
+
+			entry.Column = column;
+			entry.Pins = 1;
+			unlink(slot);
+			push_front(slot);
+
+			return { slot, false };
+		}
+
+		return Lease();
+	}
+
+	void ColumnCache::publish(const uint32_t slot)
+	{
+		std::lock_guard lock(m_mutex);
+		auto& entry = m_slots[slot];
+
+		// another worker may have built the same column meanwhile, its slot stays the cached one
+		if (m_entries.emplace(entry.Column, slot).second == false)
+			return;
+
+		entry.IsCached = true;
+		m_stats.Entries++;
+	}
+
+	void ColumnCache::release(const uint32_t slot)
+	{
+		std::lock_guard lock(m_mutex);
+		m_slots[slot].Pins--;
+	}
+
+	void ColumnCache::clear()
+	{
+		std::lock_guard lock(m_mutex);
+		m_entries.clear();
+
+		for (auto& slot: m_slots)
+		{
+			slot.IsCached = false;
+		}
+
+		m_stats.Entries = 0;
+	}
+
+	ColumnCacheStats ColumnCache::get_stats() const
+	{
+		std::lock_guard lock(m_mutex);
+
+		return m_stats;
+	}
+
+	void ColumnCache::allocate_slots()
+	{
+		m_slots.resize(m_capacity);
+		m_values.resize(m_capacity * m_fieldSize * 2);
+		m_entries.reserve(m_capacity);
+
+		for (uint32_t slot = 0; slot < static_cast<uint32_t>(m_capacity); ++slot)
+		{
+			auto& fields = m_slots[slot].Fields;
+			fields.Heights = m_values.data() + slot * m_fieldSize * 2;
+			fields.Biomes = fields.Heights + m_fieldSize;
+
+			push_front(slot);
+		}
+	}
+
+	void ColumnCache::unlink(const uint32_t slot)
+	{
+		auto& entry = m_slots[slot];
+		if (entry.Previous != NO_SLOT)
+			m_slots[entry.Previous].Next = entry.Next;
+		else
+			m_head = entry.Next;
+
+		if (entry.Next != NO_SLOT)
+			m_slots[entry.Next].Previous = entry.Previous;
+		else
+			m_tail = entry.Previous;
+
+		entry.Previous = NO_SLOT;
+		entry.Next = NO_SLOT;
+	}
+
+	void ColumnCache::push_front(const uint32_t slot)
+	{
+		auto& entry = m_slots[slot];
+		entry.Previous = NO_SLOT;
+		entry.Next = m_head;
+
+		if (m_head != NO_SLOT)
+			m_slots[m_head].Previous = slot;
+		else
+			m_tail = slot;
+
+		m_head = slot;
+	}
+}
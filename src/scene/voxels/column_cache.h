@@ -0,0 +1,115 @@
+#pragma once
+
+#include "chunk.h"
+#include "chunk_hash_map.h"
+
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace Moxel
+{
+	// 2d fields of one chunk column, chunkSize^2 values indexed z * chunkSize + x.
+	// the arrays belong to a cache slot or a worker's scratch, never to the fields
+	struct ColumnFields
+	{
+		float* Heights = nullptr; // world voxel height, voxels below it are solid
+		float* Biomes = nullptr; // climate in [0, 1], flat land near 0 and mountains near 1
+
+		float MinHeight = 0.0f;
+		float MaxHeight = 0.0f;
+	};
+
+	struct ColumnCacheStats
+	{
+		size_t Entries = 0;
+		size_t Hits = 0;
+		size_t Misses = 0;
+	};
+
+	// column fields of the recently generated (x, z) chunk columns under an LRU count budget,
+	// so every chunk stacked in a column shares one evaluation of the 2d noise. the slots are
+	// allocated once on first use and recycled after, safe to use from the generation workers at once
+	class ColumnCache
+	{
+	public:
+		ColumnCache(size_t capacity, int chunkSize);
+
+		// calls use with the fields of the column, built by build outside the lock on a miss.
+		// the slot is pinned until use returns, so eviction never overwrites fields being read
+		template<typename Build, typename Use>
+		void visit(const int x, const int z, Build&& build, Use&& use)
+		{
+			const auto lease = acquire(ChunkPosition(x, 0, z));
+			if (lease.Slot == NO_SLOT)
+			{
+				// uncached, or every slot is being read, the fields go to this worker's scratch
+				thread_local auto scratch = std::vector<float>();
+				scratch.resize(m_fieldSize * 2);
+
+				auto fields = ColumnFields{ .Heights = scratch.data(), .Biomes = scratch.data() + m_fieldSize };
+				build(fields);
+				use(static_cast<const ColumnFields&>(fields));
+
+				return;
+			}
+
+			auto& fields = m_slots[lease.Slot].Fields;
+			if (lease.IsBuilt == false)
+			{
+				build(fields);
+				publish(lease.Slot);
+			}
+
+			use(static_cast<const ColumnFields&>(fields));
+			release(lease.Slot);
+		}
+
+		void clear();
+
+		ColumnCacheStats get_stats() const;
+	private:
+		static constexpr uint32_t NO_SLOT = UINT32_MAX;
+
+		struct Slot
+		{
+			ChunkPosition Column = ChunkPosition(0, 0, 0);
+			ColumnFields Fields;
+
+			// intrusive LRU list over every slot, most recently used at m_head
+			uint32_t Previous = NO_SLOT;
+			uint32_t Next = NO_SLOT;
+
+			uint32_t Pins = 0; // visits still reading or building the fields
+			bool IsCached = false; // reachable through m_entries
+		};
+
+		struct Lease
+		{
+			uint32_t Slot = NO_SLOT;
+			bool IsBuilt = false;
+		};
+
+		// pins the column's slot, or the least recently used one nobody reads to build it in
+		Lease acquire(ChunkPosition column);
+		void publish(uint32_t slot);
+		void release(uint32_t slot);
+
+		void allocate_slots();
+		void unlink(uint32_t slot);
+		void push_front(uint32_t slot);
+
+		size_t m_capacity = 0;
+		size_t m_fieldSize = 0; // values per field, chunkSize^2
+
+		std::vector<Slot> m_slots;
+		std::vector<float> m_values; // heights then biomes of every slot
+		ChunkHashMap<uint32_t> m_entries; // slot of each cached column, keyed by (x, 0, z)
+
+		uint32_t m_head = NO_SLOT;
+		uint32_t m_tail = NO_SLOT;
+
+		ColumnCacheStats m_stats;
+		mutable std::mutex m_mutex;
+	};
+}
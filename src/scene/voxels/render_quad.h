@@ -1,22 +1,10 @@
 #pragma once
 
+#include <cstdint>
 #include <glm/glm.hpp>
 
 namespace Moxel
 {
-	struct VoxelVertex
-	{
-		uint32_t Position;
-		glm::vec3 Color;
-
-		VoxelVertex() = default;
-		VoxelVertex(const glm::u8vec3 localCoord, const glm::vec3 color) 
-		{
-			Color = color;
-			Position = static_cast<uint32_t>(localCoord.x) | static_cast<uint32_t>(localCoord.y) << 5 | static_cast<uint32_t>(localCoord.z) << 10;
-		}
-	};
-
 	enum class Side
 	{
 		FRONT,
@@ -27,18 +15,60 @@ namespace Moxel
 		DOWN
 	};
 
-	class RenderQuad
+	// one quad in 8 bytes, the vertex shader pulls it from a storage buffer and expands the corners.
+	// Position: bits 0-17 minimum voxel (6 bits per axis), 18-23 width - 1, 24-29 height - 1
+	// Attributes: bits 0-2 normal as Side, 3-10 ao level per corner (2 bits each), 16-31 block id
+	// width and height run along the two axes following the normal axis, so y and z for LEFT / RIGHT,
+	// z and x for UP / DOWN, x and y for FRONT / BACK
+	struct VoxelFace
 	{
-	public:
-		RenderQuad(Side side, glm::u8vec3 position);
+		static constexpr uint32_t COORD_BITS = 6;
+		static constexpr uint32_t COORD_MASK = (1u << COORD_BITS) - 1;
+		static constexpr uint32_t WIDTH_SHIFT = COORD_BITS * 3;
+		static constexpr uint32_t HEIGHT_SHIFT = WIDTH_SHIFT + COORD_BITS;
+		static constexpr uint32_t AO_SHIFT = 3;
+		static constexpr uint32_t MAX_AO = 3;
+		static constexpr uint32_t MATERIAL_SHIFT = 16;
 
-		void add_indices_offset(int value);
+		uint32_t Position;
+		uint32_t Attributes;
 
-		const std::vector<VoxelVertex>& get_vertices() const { return m_vertices; }
-		const std::vector<uint32_t>& get_indices() const { return m_indices; }
+		VoxelFace() = default;
+		VoxelFace(const uint32_t x, const uint32_t y, const uint32_t z, const uint32_t width, const uint32_t height, const Side normal, const uint32_t material)
+			: Position(x | y << COORD_BITS | z << (COORD_BITS * 2) | (width - 1) << WIDTH_SHIFT | (height - 1) << HEIGHT_SHIFT),
+			  Attributes(static_cast<uint32_t>(normal) | material << MATERIAL_SHIFT) { }
 
-	private:
-		std::vector<VoxelVertex> m_vertices;
-		std::vector<uint32_t> m_indices;
+		glm::u8vec3 get_origin() const { return glm::u8vec3(Position & COORD_MASK, (Position >> COORD_BITS) & COORD_MASK, (Position >> (COORD_BITS * 2)) & COORD_MASK); }
+		uint32_t get_width() const { return ((Position >> WIDTH_SHIFT) & COORD_MASK) + 1; }
+		uint32_t get_height() const { return ((Position >> HEIGHT_SHIFT) & COORD_MASK) + 1; }
+		Side get_normal() const { return static_cast<Side>(Attributes & 7); }
+		uint32_t get_ao(const int corner) const { return (Attributes >> (AO_SHIFT + corner * 2)) & MAX_AO; }
+		uint32_t get_material() const { return Attributes >> MATERIAL_SHIFT; }
 	};
-}
\ No newline at end of file
+
+	static_assert(sizeof(VoxelFace) == 8, "Voxel face must stay 8 bytes");
+
+	// sides come in opposite pairs
+	inline Side get_opposite_side(const Side side) { return static_cast<Side>(static_cast<int>(side) ^ 1); }
+
+	// axis the side's normal points along, 0 for x
+	inline int get_side_axis(const Side side)
+	{
+		constexpr int axes[3] = { 2, 0, 1 };
+
+		return axes[static_cast<int>(side) >> 1];
+	}
+
+	// quad corners as 0/1 offsets per axis indexed by Side, counter clockwise seen from outside
+	inline constexpr uint8_t QUAD_CORNERS[6][4][3] = {
+		{ {1, 0, 1}, {1, 1, 1}, {0, 1, 1}, {0, 0, 1} }, // FRONT
+		{ {0, 0, 0}, {0, 1, 0}, {1, 1, 0}, {1, 0, 0} }, // BACK
+		{ {0, 0, 0}, {0, 0, 1}, {0, 1, 1}, {0, 1, 0} }, // LEFT
+		{ {1, 1, 0}, {1, 1, 1}, {1, 0, 1}, {1, 0, 0} }, // RIGHT
+		{ {0, 1, 1}, {1, 1, 1}, {1, 1, 0}, {0, 1, 0} }, // UP
+		{ {0, 0, 0}, {1, 0, 0}, {1, 0, 1}, {0, 0, 1} } // DOWN
+	};
+
+	// corner c of quad q is vertex q * 4 + c
+	inline constexpr uint32_t QUAD_INDICES[6] = { 0, 1, 2, 0, 2, 3 };
+}
@@ -0,0 +1,325 @@
+#include "world_generation.h"
+#include "engine/core/logger/log.h"
+
+#include <algorithm>
+#include <bit>
+#include <limits>
+
+namespace Moxel
+{
+	static constexpr int CAVE_OCTAVES = 2;
+	static constexpr int ORE_OCTAVES = 1;
+	static constexpr int HEIGHT_OCTAVES = 4;
+	static constexpr int BIOME_OCTAVES = 1;
+
+	// biomes change this many times slower than the height field
+	static constexpr double BIOME_SCALE = 0.125;
+
+	// voxel offsets that move caves and ores off the part of the noise the terrain samples
+	static constexpr int CAVE_NOISE_OFFSET = 10007;
+	static constexpr int ORE_NOISE_OFFSET = 20011;
+
+	// the 2d fields are slices of the 3d noise at fixed y, off the lattice so they never flatten out
+	static constexpr double HEIGHT_NOISE_PLANE = 0.5;
+	static constexpr double BIOME_NOISE_PLANE = 1000.5;
+
+	static int get_index(const int chunkSize, const int x, const int y, const int z)
+	{
+		return (z * chunkSize + y) * chunkSize + x;
+	}
+
+	// Target voxels whose noise is above the threshold become block, noise is only sampled
+	// for the batches of a row that have solid voxels
+	static void replace_by_noise(const GenerationPass& pass, Chunk& chunk, const glm::ivec3& origin, const WorldNoise& noise, const int offset, const int octaves, const BlockId block)
+	{
+		constexpr int BATCH_SIZE = WorldNoise::BATCH_SIZE;
+		const int chunkSize = chunk.get_chunk_size();
+		const auto frequency = static_cast<double>(pass.Frequency);
+
+		double pointsX[64], pointsY[BATCH_SIZE], pointsZ[BATCH_SIZE], density[64];
+		for (int x = 0; x < chunkSize; ++x)
+		{
+			pointsX[x] = (origin.x + x + offset) * frequency;
+		}
+
+		for (int z = 0; z < chunkSize; ++z)
+		{
+			std::fill_n(pointsZ, BATCH_SIZE, (origin.z + z + offset) * frequency);
+			for (int y = 0; y < chunkSize; ++y)
+			{
+				const uint64_t row = chunk.get_row(y, z);
+				if (row == 0)
+					continue;
+
+				std::fill_n(pointsY, BATCH_SIZE, (origin.y + y + offset) * frequency);
+				for (int x = 0; x < chunkSize; x += BATCH_SIZE)
+				{
+					if (((row >> x) & ((1ull << BATCH_SIZE) - 1)) != 0)
+						noise.octave3D_01(pointsX + x, pointsY, pointsZ, density + x, octaves);
+				}
+
+				for (uint64_t bits = row; bits != 0; bits &= bits - 1)
+				{
+					const int x = std::countr_zero(bits);
+					const int index = get_index(chunkSize, x, y, z);
+
+					if (density[x] > pass.Threshold && chunk.get_block_type(index) == pass.Target)
+						chunk.set_block_type(index, block);
+				}
+			}
+		}
+	}
+
+	static void build_column_fields(const GenerationPass& pass, const int chunkSize, const int columnX, const int columnZ, const WorldNoise& noise, ColumnFields& fields)
+	{
+		constexpr int BATCH_SIZE = WorldNoise::BATCH_SIZE;
+		const auto frequency = static_cast<double>(pass.Frequency);
+
+		fields.MinHeight = std::numeric_limits<float>::max();
+		fields.MaxHeight = std::numeric_limits<float>::lowest();
+
+		double pointsX[64], biomeX[64], heightY[BATCH_SIZE], biomeY[BATCH_SIZE], pointsZ[BATCH_SIZE], biomeZ[BATCH_SIZE], hills[64], biomes[64];
+		for (int x = 0; x < chunkSize; ++x)
+		{
+			pointsX[x] = (columnX * chunkSize + x) * frequency;
+			biomeX[x] = pointsX[x] * BIOME_SCALE;
+		}
+
+		std::fill_n(heightY, BATCH_SIZE, HEIGHT_NOISE_PLANE);
+		std::fill_n(biomeY, BATCH_SIZE, BIOME_NOISE_PLANE);
+
+		for (int z = 0; z < chunkSize; ++z)
+		{
+			std::fill_n(pointsZ, BATCH_SIZE, (columnZ * chunkSize + z) * frequency);
+			std::fill_n(biomeZ, BATCH_SIZE, pointsZ[0] * BIOME_SCALE);
+
+			for (int x = 0; x < chunkSize; x += BATCH_SIZE)
+			{
+				noise.octave3D_01(pointsX + x, heightY, pointsZ, hills + x, HEIGHT_OCTAVES);
+				noise.octave3D_01(biomeX + x, biomeY, biomeZ, biomes + x, BIOME_OCTAVES);
+			}
+
+			for (int x = 0; x < chunkSize; ++x)
+			{
+				// flat biomes keep close to Height, mountainous ones reach twice the amplitude
+				const int index = z * chunkSize + x;
+				const auto height = static_cast<float>(pass.Height + (hills[x] * 2.0 - 1.0) * pass.Amplitude * biomes[x] * 2.0);
+
+				fields.Heights[index] = height;
+				fields.Biomes[index] = static_cast<float>(biomes[x]);
+				fields.MinHeight = std::min(fields.MinHeight, height);
+				fields.MaxHeight = std::max(fields.MaxHeight, height);
+			}
+		}
+	}
+
+	static void grow_surface(const GenerationPass& pass, Chunk& chunk, const GenerationNeighborhood& neighbors)
+	{
+		const int chunkSize = chunk.get_chunk_size();
+		for (int z = 0; z < chunkSize; ++z)
+		{
+			for (int x = 0; x < chunkSize; ++x)
+			{
+				// top down from the highest voxel whose air can reach into the chunk
+				int sinceAir = pass.Depth + 1;
+				for (int y = chunkSize - 1 + pass.Depth; y >= 0; --y)
+				{
+					const int index = get_index(chunkSize, x, y, z);
+					const bool isSolid = y < chunkSize ? chunk.get_block(index) : neighbors.is_solid({ x, y, z });
+					if (isSolid == false)
+					{
+						sinceAir = 0;
+						continue;
+					}
+
+					sinceAir++;
+					if (y < chunkSize && sinceAir <= pass.Depth && chunk.get_block_type(index) == pass.Target)
+						chunk.set_block_type(index, pass.Block);
+				}
+			}
+		}
+	}
+
+	// columns are picked per world (x, z), so every chunk a column crosses agrees on it. a column
+	// grows from every Target voxel in it through air and its own blocks, and only the part inside
+	// this chunk is written, which the chunks above write for themselves
+	static void place_decorations(const GenerationPass& pass, Chunk& chunk, const glm::ivec3& origin, const GenerationNeighborhood& neighbors, const uint32_t seed)
+	{
+		const int chunkSize = chunk.get_chunk_size();
+		const auto get_block_type = [&chunk, &neighbors, chunkSize](const int x, const int y, const int z)
+		{
+			return y >= 0 && y < chunkSize ? chunk.get_block_type(get_index(chunkSize, x, y, z)) : neighbors.get_block_type({ x, y, z });
+		};
+
+		for (int z = 0; z < chunkSize; ++z)
+		{
+			for (int x = 0; x < chunkSize; ++x)
+			{
+				const uint64_t hash = ChunkPosition::mix(ChunkPosition(origin.x + x, 0, origin.z + z).pack() ^ seed);
+				if (static_cast<double>(hash >> 11) * 0x1.0p-53 >= pass.Threshold)
+					continue;
+
+				for (int root = -pass.Depth; root < chunkSize; ++root)
+				{
+					if (get_block_type(x, root, z) != pass.Target)
+						continue;
+
+					for (int y = root + 1; y <= root + pass.Depth && y < chunkSize; ++y)
+					{
+						const auto block = get_block_type(x, y, z);
+						if (block != AIR_BLOCK && block != pass.Block)
+							break;
+
+						if (y >= 0 && block == AIR_BLOCK)
+							chunk.set_block_type(get_index(chunkSize, x, y, z), pass.Block);
+					}
+				}
+			}
+		}
+	}
+
+	std::vector<GenerationPass> get_layered_generation_passes()
+	{
+		return {
+			{ .Type = GenerationPassType::BASE_DENSITY },
+			{ .Type = GenerationPassType::CAVES, .Block = AIR_BLOCK, .Target = DEFAULT_BLOCK, .Frequency = 0.03f, .Threshold = 0.72 },
+			{ .Type = GenerationPassType::SURFACE, .NeighborRadius = 1, .Block = SURFACE_BLOCK, .Target = DEFAULT_BLOCK, .Depth = 3 },
+			{ .Type = GenerationPassType::ORES, .Block = ORE_BLOCK, .Target = DEFAULT_BLOCK, .Frequency = 0.15f, .Threshold = 0.8 },
+			{ .Type = GenerationPassType::DECORATIONS, .NeighborRadius = 1, .Block = DECORATION_BLOCK, .Target = SURFACE_BLOCK, .Threshold = 0.01, .Depth = 5 }
+		};
+	}
+
+	std::vector<GenerationPass> get_height_generation_passes()
+	{
+		auto passes = get_layered_generation_passes();
+		passes[0] = { .Type = GenerationPassType::BASE_HEIGHT, .Frequency = 0.01f, .Height = 0, .Amplitude = 48 };
+
+		return passes;
+	}
+
+	const char* get_generation_pass_name(const GenerationPassType type)
+	{
+		switch (type)
+		{
+			case GenerationPassType::BASE_HEIGHT: return "base height";
+			case GenerationPassType::CAVES: return "caves";
+			case GenerationPassType::SURFACE: return "surface";
+			case GenerationPassType::ORES: return "ores";
+			case GenerationPassType::DECORATIONS: return "decorations";
+			default: return "base density";
+		}
+	}
+
+	bool is_base_generation_pass(const GenerationPassType type)
+	{
+		return type == GenerationPassType::BASE_DENSITY || type == GenerationPassType::BASE_HEIGHT;
+	}
+
+	int get_min_neighbor_radius(const GenerationPassType type)
+	{
+		switch (type)
+		{
+			case GenerationPassType::SURFACE:
+			case GenerationPassType::DECORATIONS: return 1;
+			default: return 0;
+		}
+	}
+
+	int get_dependency_radius(const std::vector<GenerationPass>& passes, const int pass)
+	{
+		if (pass == 0)
+			return 0;
+
+		return std::max(passes[pass].NeighborRadius, passes[pass - 1].NeighborRadius);
+	}
+
+	int get_generation_reach(const std::vector<GenerationPass>& passes)
+	{
+		int reach = 0;
+		for (int pass = 0; pass < static_cast<int>(passes.size()); ++pass)
+		{
+			reach += get_dependency_radius(passes, pass);
+		}
+
+		return reach;
+	}
+
+	GenerationNeighborhood::GenerationNeighborhood(const int chunkSize, const int radius)
+	{
+		m_chunkSize = chunkSize;
+		m_bitSize = std::countr_zero(static_cast<unsigned>(chunkSize));
+		m_radius = radius;
+
+		const int extent = radius * 2 + 1;
+		m_chunks.resize(static_cast<size_t>(extent) * extent * extent);
+	}
+
+	void GenerationNeighborhood::set(const glm::ivec3 offset, std::shared_ptr<const Chunk> chunk)
+	{
+		m_chunks[get_slot(offset)] = std::move(chunk);
+	}
+
+	BlockId GenerationNeighborhood::get_block_type(const glm::ivec3 voxel) const
+	{
+		// arithmetic shifts floor negative voxels into the chunk below
+		const auto offset = glm::ivec3(voxel.x >> m_bitSize, voxel.y >> m_bitSize, voxel.z >> m_bitSize);
+		const auto& chunk = m_chunks[get_slot(offset)];
+		if (chunk == nullptr)
+			return AIR_BLOCK;
+
+		const int mask = m_chunkSize - 1;
+
+		return chunk->get_block_type(get_index(m_chunkSize, voxel.x & mask, voxel.y & mask, voxel.z & mask));
+	}
+
+	int GenerationNeighborhood::get_slot(const glm::ivec3 offset) const
+	{
+		LOG_ASSERT((std::max({ abs(offset.x), abs(offset.y), abs(offset.z) }) <= m_radius), "Generation pass reads past its neighbor radius");
+
+		const int extent = m_radius * 2 + 1;
+
+		return ((offset.z + m_radius) * extent + offset.y + m_radius) * extent + offset.x + m_radius;
+	}
+
+	void apply_generation_pass(const GenerationPass& pass, Chunk& chunk, const ChunkPosition position, const GenerationNeighborhood& neighbors, const WorldNoise& noise, ColumnCache& columns, const int sampleStep)
+	{
+		const auto origin = glm::ivec3(position.X, position.Y, position.Z) * chunk.get_chunk_size();
+
+		switch (pass.Type)
+		{
+			case GenerationPassType::BASE_DENSITY:
+				chunk.generate_data(position, noise, sampleStep);
+				break;
+			case GenerationPassType::BASE_HEIGHT:
+			{
+				// every chunk stacked in the column reuses the fields of the first one generated
+				const int chunkSize = chunk.get_chunk_size();
+				columns.visit(position.X, position.Z, [&pass, chunkSize, position, &noise](ColumnFields& fields)
+				{
+					build_column_fields(pass, chunkSize, position.X, position.Z, noise, fields);
+				},
+				[&chunk, position](const ColumnFields& fields)
+				{
+					chunk.generate_heights(position, fields.Heights, fields.MinHeight, fields.MaxHeight);
+				});
+				break;
+			}
+			case GenerationPassType::CAVES:
+				replace_by_noise(pass, chunk, origin, noise, CAVE_NOISE_OFFSET, CAVE_OCTAVES, AIR_BLOCK);
+				break;
+			case GenerationPassType::SURFACE:
+				if (chunk.get_summary().is_empty() == false)
+					grow_surface(pass, chunk, neighbors);
+				break;
+			case GenerationPassType::ORES:
+				replace_by_noise(pass, chunk, origin, noise, ORE_NOISE_OFFSET, ORE_OCTAVES, pass.Block);
+				break;
+			case GenerationPassType::DECORATIONS:
+				place_decorations(pass, chunk, origin, neighbors, noise.get_seed());
+				break;
+		}
+
+		// carving and replacing can leave a chunk of one block
+		chunk.try_make_uniform();
+	}
+}
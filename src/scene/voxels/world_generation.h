@@ -0,0 +1,95 @@
+#pragma once
+
+#include "chunk.h"
+#include "column_cache.h"
+#include "world_noise.h"
+
+#include <glm/glm.hpp>
+#include <memory>
+#include <vector>
+
+namespace Moxel
+{
+	// blocks of get_layered_generation_passes
+	constexpr BlockId SURFACE_BLOCK = 2;
+	constexpr BlockId ORE_BLOCK = 3;
+	constexpr BlockId DECORATION_BLOCK = 4;
+
+	enum class GenerationPassType
+	{
+		BASE_DENSITY, // Chunk::generate_data's noise threshold, always the first pass
+		BASE_HEIGHT, // first pass instead of the density, solid below a 2d height field shared by the chunk column
+		CAVES, // Target voxels become air where a second noise is above Threshold
+		SURFACE, // Target voxels with air up to Depth voxels above become Block
+		ORES, // Target voxels become Block where a high frequency noise is above Threshold
+		DECORATIONS // in a Threshold share of the (x, z) columns, Block grows up to Depth voxels through air from Target voxels
+	};
+
+	// one step of world generation, plain data so a world lists its own passes in ChunkWorldSpecs.
+	// a pass reads the chunks up to NeighborRadius away and only ever writes its own chunk
+	struct GenerationPass
+	{
+		GenerationPassType Type = GenerationPassType::BASE_DENSITY;
+		int NeighborRadius = 0;
+
+		BlockId Block = DEFAULT_BLOCK; // placed
+		BlockId Target = DEFAULT_BLOCK; // replaced, or grown from for decorations
+
+		float Frequency = 0.0f; // noise per voxel
+		double Threshold = 0.0; // noise level, or share of the columns for decorations
+		int Depth = 0; // surface layer thickness, decoration height, below the chunk size
+
+		int Height = 0; // world voxel level the height field strays around
+		int Amplitude = 0; // how far it strays, scaled by the column's biome
+	};
+
+	// what the pass after the base density adds to the terrain, in the order it runs
+	std::vector<GenerationPass> get_layered_generation_passes();
+
+	// the same layers over a base height pass, whose 2d fields the column cache shares down each column
+	std::vector<GenerationPass> get_height_generation_passes();
+
+	const char* get_generation_pass_name(GenerationPassType type);
+
+	// passes that fill the chunk from nothing, only ever the first one
+	bool is_base_generation_pass(GenerationPassType type);
+
+	// passes that look past their own chunk need at least this radius
+	int get_min_neighbor_radius(GenerationPassType type);
+
+	// a chunk may run pass i once every chunk this many chunks away finished pass i - 1. the radius
+	// of pass i - 1 is included, so no neighbour moves on to writes that a read of pass i - 1 still sees
+	int get_dependency_radius(const std::vector<GenerationPass>& passes, int pass);
+
+	// how far past a finished chunk the passes reach through their dependencies
+	int get_generation_reach(const std::vector<GenerationPass>& passes);
+
+	// chunks around one chunk at the stage a pass reads them, missing chunks read as air
+	class GenerationNeighborhood
+	{
+	public:
+		GenerationNeighborhood(int chunkSize, int radius);
+
+		// offset in chunks from the center, within the radius
+		void set(glm::ivec3 offset, std::shared_ptr<const Chunk> chunk);
+
+		// voxel relative to the center chunk's origin
+		BlockId get_block_type(glm::ivec3 voxel) const;
+		bool is_solid(const glm::ivec3 voxel) const { return get_block_type(voxel) != AIR_BLOCK; }
+
+		int get_radius() const { return m_radius; }
+	private:
+		int get_slot(glm::ivec3 offset) const;
+
+		int m_chunkSize = 0;
+		int m_bitSize = 0;
+		int m_radius = 0;
+
+		std::vector<std::shared_ptr<const Chunk>> m_chunks; // (2 * radius + 1)^3, x fastest
+	};
+
+	// runs one pass over chunk, which holds the result of the previous passes. a pass must not
+	// change what it reads, neighbours running the same pass may be seen before or after it.
+	// columns holds the 2d fields of the world's one height pass
+	void apply_generation_pass(const GenerationPass& pass, Chunk& chunk, ChunkPosition position, const GenerationNeighborhood& neighbors, const WorldNoise& noise, ColumnCache& columns, int sampleStep);
+}
@@ -0,0 +1,389 @@
+#include "world_noise.h"
+#include "engine/core/cpu_features.h"
+#include "engine/core/logger/log.h"
+
+#include <PerlinNoise.hpp>
+#include <algorithm>
+#include <cmath>
+
+#if defined(MOXEL_ARCH_X86)
+#include <immintrin.h>
+#endif
+
+namespace Moxel
+{
+	// same expressions as siv::perlin_detail, in the same order
+	static double fade(const double t) { return t * t * t * (t * (t * 6 - 15) + 10); }
+	static double lerp(const double a, const double b, const double t) { return a + (b - a) * t; }
+
+	static double grad(const int32_t hash, const double x, const double y, const double z)
+	{
+		const int32_t h = hash & 15;
+		const double u = h < 8 ? x : y;
+		const double v = h < 4 ? y : h == 12 || h == 14 ? x : z;
+
+		return ((h & 1) == 0 ? u : -u) + ((h & 2) == 0 ? v : -v);
+	}
+
+	static double remap_clamp_01(const double value)
+	{
+		if (value <= -1.0)
+			return 0.0;
+
+		if (value >= 1.0)
+			return 1.0;
+
+		return value * 0.5 + 0.5;
+	}
+
+	static double noise3D(const int32_t* p, const double x, const double y, const double z)
+	{
+		const double floorX = std::floor(x);
+		const double floorY = std::floor(y);
+		const double floorZ = std::floor(z);
+
+		const int32_t ix = static_cast<int32_t>(floorX) & 255;
+		const int32_t iy = static_cast<int32_t>(floorY) & 255;
+		const int32_t iz = static_cast<int32_t>(floorZ) & 255;
+
+		const double fx = x - floorX;
+		const double fy = y - floorY;
+		const double fz = z - floorZ;
+
+		const double u = fade(fx);
+		const double v = fade(fy);
+		const double w = fade(fz);
+
+		const int32_t a = (p[ix] + iy) & 255;
+		const int32_t b = (p[ix + 1] + iy) & 255;
+
+		const int32_t aa = (p[a] + iz) & 255;
+		const int32_t ab = (p[a + 1] + iz) & 255;
+		const int32_t ba = (p[b] + iz) & 255;
+		const int32_t bb = (p[b + 1] + iz) & 255;
+
+		const double p0 = grad(p[aa], fx, fy, fz);
+		const double p1 = grad(p[ba], fx - 1, fy, fz);
+		const double p2 = grad(p[ab], fx, fy - 1, fz);
+		const double p3 = grad(p[bb], fx - 1, fy - 1, fz);
+		const double p4 = grad(p[aa + 1], fx, fy, fz - 1);
+		const double p5 = grad(p[ba + 1], fx - 1, fy, fz - 1);
+		const double p6 = grad(p[ab + 1], fx, fy - 1, fz - 1);
+		const double p7 = grad(p[bb + 1], fx - 1, fy - 1, fz - 1);
+
+		const double q0 = lerp(p0, p1, u);
+		const double q1 = lerp(p2, p3, u);
+		const double q2 = lerp(p4, p5, u);
+		const double q3 = lerp(p6, p7, u);
+
+		return lerp(lerp(q0, q1, v), lerp(q2, q3, v), w);
+	}
+
+	// lerp of independent ranges, weights stay in [0, 1], so the extremes sit at the ends of t
+	static NoiseBounds lerp_bounds(const NoiseBounds& a, const NoiseBounds& b, const double t0, const double t1)
+	{
+		return {
+			std::min(lerp(a.Min, b.Min, t0), lerp(a.Min, b.Min, t1)),
+			std::max(lerp(a.Max, b.Max, t0), lerp(a.Max, b.Max, t1))
+		};
+	}
+
+	// range of grad over a box, u and v are always different axes so their ranges add up independently
+	static NoiseBounds grad_bounds(const int32_t hash, const glm::dvec3& min, const glm::dvec3& max)
+	{
+		const int32_t h = hash & 15;
+		const int u = h < 8 ? 0 : 1;
+		const int v = h < 4 ? 1 : h == 12 || h == 14 ? 0 : 2;
+
+		const auto uBounds = (h & 1) == 0 ? NoiseBounds { min[u], max[u] } : NoiseBounds { -max[u], -min[u] };
+		const auto vBounds = (h & 2) == 0 ? NoiseBounds { min[v], max[v] } : NoiseBounds { -max[v], -min[v] };
+
+		return { uBounds.Min + vBounds.Min, uBounds.Max + vBounds.Max };
+	}
+
+	// interval form of noise3D over one lattice cell, f0 and f1 are the box corners in cell coordinates
+	static NoiseBounds cell_bounds(const int32_t* p, const glm::dvec3& cell, const glm::dvec3& f0, const glm::dvec3& f1)
+	{
+		const int32_t ix = static_cast<int32_t>(cell.x) & 255;
+		const int32_t iy = static_cast<int32_t>(cell.y) & 255;
+		const int32_t iz = static_cast<int32_t>(cell.z) & 255;
+
+		const int32_t a = (p[ix] + iy) & 255;
+		const int32_t b = (p[ix + 1] + iy) & 255;
+
+		const int32_t aa = (p[a] + iz) & 255;
+		const int32_t ab = (p[a + 1] + iz) & 255;
+		const int32_t ba = (p[b] + iz) & 255;
+		const int32_t bb = (p[b + 1] + iz) & 255;
+
+		// in the order of p0..p7 in noise3D
+		const int32_t hashes[8] = { p[aa], p[ba], p[ab], p[bb], p[aa + 1], p[ba + 1], p[ab + 1], p[bb + 1] };
+
+		NoiseBounds corners[8];
+		for (int i = 0; i < 8; ++i)
+		{
+			const auto offset = glm::dvec3(i & 1, (i >> 1) & 1, (i >> 2) & 1);
+			corners[i] = grad_bounds(hashes[i], f0 - offset, f1 - offset);
+		}
+
+		const double u0 = fade(f0.x), u1 = fade(f1.x);
+		const double v0 = fade(f0.y), v1 = fade(f1.y);
+		const double w0 = fade(f0.z), w1 = fade(f1.z);
+
+		const auto q0 = lerp_bounds(corners[0], corners[1], u0, u1);
+		const auto q1 = lerp_bounds(corners[2], corners[3], u0, u1);
+		const auto q2 = lerp_bounds(corners[4], corners[5], u0, u1);
+		const auto q3 = lerp_bounds(corners[6], corners[7], u0, u1);
+
+		return lerp_bounds(lerp_bounds(q0, q1, v0, v1), lerp_bounds(q2, q3, v0, v1), w0, w1);
+	}
+
+	// union of the cell bounds of every lattice cell the box touches
+	static NoiseBounds noise3D_bounds(const int32_t* p, const glm::dvec3& min, const glm::dvec3& max)
+	{
+		const auto first = glm::floor(min);
+		const auto last = glm::floor(max);
+
+		auto bounds = NoiseBounds { INFINITY, -INFINITY };
+		for (double z = first.z; z <= last.z; ++z)
+		{
+			for (double y = first.y; y <= last.y; ++y)
+			{
+				for (double x = first.x; x <= last.x; ++x)
+				{
+					const auto cell = glm::dvec3(x, y, z);
+					const auto cellBounds = cell_bounds(p, cell, glm::max(min - cell, 0.0), glm::min(max - cell, 1.0));
+
+					bounds.Min = std::min(bounds.Min, cellBounds.Min);
+					bounds.Max = std::max(bounds.Max, cellBounds.Max);
+				}
+			}
+		}
+
+		return bounds;
+	}
+
+#if defined(MOXEL_ARCH_X86)
+	MOXEL_TARGET_AVX2 static inline __m256d fade_avx2(const __m256d t)
+	{
+		const __m256d inner = _mm256_add_pd(_mm256_mul_pd(t, _mm256_sub_pd(_mm256_mul_pd(t, _mm256_set1_pd(6.0)), _mm256_set1_pd(15.0))), _mm256_set1_pd(10.0));
+
+		return _mm256_mul_pd(_mm256_mul_pd(_mm256_mul_pd(t, t), t), inner);
+	}
+
+	MOXEL_TARGET_AVX2 static inline __m256d lerp_avx2(const __m256d a, const __m256d b, const __m256d t)
+	{
+		return _mm256_add_pd(a, _mm256_mul_pd(_mm256_sub_pd(b, a), t));
+	}
+
+	// the branches of grad as blends, negation as a sign bit flip
+	MOXEL_TARGET_AVX2 static inline __m256d grad_avx2(const __m128i hash, const __m256d x, const __m256d y, const __m256d z)
+	{
+		const __m256i h = _mm256_cvtepi32_epi64(_mm_and_si128(hash, _mm_set1_epi32(15)));
+
+		const __m256i isHigh = _mm256_cmpgt_epi64(h, _mm256_set1_epi64x(7));
+		const __m256i isLow = _mm256_cmpgt_epi64(_mm256_set1_epi64x(4), h);
+		const __m256i isX = _mm256_or_si256(_mm256_cmpeq_epi64(h, _mm256_set1_epi64x(12)), _mm256_cmpeq_epi64(h, _mm256_set1_epi64x(14)));
+
+		const __m256d u = _mm256_blendv_pd(x, y, _mm256_castsi256_pd(isHigh));
+		const __m256d v = _mm256_blendv_pd(_mm256_blendv_pd(z, x, _mm256_castsi256_pd(isX)), y, _mm256_castsi256_pd(isLow));
+
+		const __m256d uSign = _mm256_castsi256_pd(_mm256_slli_epi64(h, 63));
+		const __m256d vSign = _mm256_castsi256_pd(_mm256_slli_epi64(_mm256_srli_epi64(h, 1), 63));
+
+		return _mm256_add_pd(_mm256_xor_pd(u, uSign), _mm256_xor_pd(v, vSign));
+	}
+
+	MOXEL_TARGET_AVX2 static inline __m128i lookup_avx2(const int32_t* permutation, const __m128i index)
+	{
+		return _mm_i32gather_epi32(permutation, index, 4);
+	}
+
+	// (permutation[index] + offset) & 255
+	MOXEL_TARGET_AVX2 static inline __m128i hash_avx2(const int32_t* permutation, const __m128i index, const __m128i offset)
+	{
+		return _mm_and_si128(_mm_add_epi32(lookup_avx2(permutation, index), offset), _mm_set1_epi32(255));
+	}
+
+	// four points, the lattice hashes in 32 bit lanes and the gradients in doubles
+	MOXEL_TARGET_AVX2 static __m256d noise3D_avx2(const int32_t* permutation, const __m256d x, const __m256d y, const __m256d z)
+	{
+		const __m256d floorX = _mm256_floor_pd(x);
+		const __m256d floorY = _mm256_floor_pd(y);
+		const __m256d floorZ = _mm256_floor_pd(z);
+
+		const __m128i mask = _mm_set1_epi32(255);
+		const __m128i one = _mm_set1_epi32(1);
+		const __m128i ix = _mm_and_si128(_mm256_cvttpd_epi32(floorX), mask);
+		const __m128i iy = _mm_and_si128(_mm256_cvttpd_epi32(floorY), mask);
+		const __m128i iz = _mm_and_si128(_mm256_cvttpd_epi32(floorZ), mask);
+
+		const __m256d fx = _mm256_sub_pd(x, floorX);
+		const __m256d fy = _mm256_sub_pd(y, floorY);
+		const __m256d fz = _mm256_sub_pd(z, floorZ);
+
+		const __m256d u = fade_avx2(fx);
+		const __m256d v = fade_avx2(fy);
+		const __m256d w = fade_avx2(fz);
+
+		const __m128i a = hash_avx2(permutation, ix, iy);
+		const __m128i b = hash_avx2(permutation, _mm_add_epi32(ix, one), iy);
+
+		const __m128i aa = hash_avx2(permutation, a, iz);
+		const __m128i ab = hash_avx2(permutation, _mm_add_epi32(a, one), iz);
+		const __m128i ba = hash_avx2(permutation, b, iz);
+		const __m128i bb = hash_avx2(permutation, _mm_add_epi32(b, one), iz);
+
+		const __m256d fx1 = _mm256_sub_pd(fx, _mm256_set1_pd(1.0));
+		const __m256d fy1 = _mm256_sub_pd(fy, _mm256_set1_pd(1.0));
+		const __m256d fz1 = _mm256_sub_pd(fz, _mm256_set1_pd(1.0));
+
+		const __m256d p0 = grad_avx2(lookup_avx2(permutation, aa), fx, fy, fz);
+		const __m256d p1 = grad_avx2(lookup_avx2(permutation, ba), fx1, fy, fz);
+		const __m256d p2 = grad_avx2(lookup_avx2(permutation, ab), fx, fy1, fz);
+		const __m256d p3 = grad_avx2(lookup_avx2(permutation, bb), fx1, fy1, fz);
+		const __m256d p4 = grad_avx2(lookup_avx2(permutation, _mm_add_epi32(aa, one)), fx, fy, fz1);
+		const __m256d p5 = grad_avx2(lookup_avx2(permutation, _mm_add_epi32(ba, one)), fx1, fy, fz1);
+		const __m256d p6 = grad_avx2(lookup_avx2(permutation, _mm_add_epi32(ab, one)), fx, fy1, fz1);
+		const __m256d p7 = grad_avx2(lookup_avx2(permutation, _mm_add_epi32(bb, one)), fx1, fy1, fz1);
+
+		const __m256d q0 = lerp_avx2(p0, p1, u);
+		const __m256d q1 = lerp_avx2(p2, p3, u);
+		const __m256d q2 = lerp_avx2(p4, p5, u);
+		const __m256d q3 = lerp_avx2(p6, p7, u);
+
+		return lerp_avx2(lerp_avx2(q0, q1, v), lerp_avx2(q2, q3, v), w);
+	}
+
+	MOXEL_TARGET_AVX2 static void octave3D_01_avx2(const int32_t* permutation, const double* x, const double* y, const double* z, double* values, const int octaves)
+	{
+		for (int i = 0; i < WorldNoise::BATCH_SIZE; i += 4)
+		{
+			__m256d pointX = _mm256_loadu_pd(x + i);
+			__m256d pointY = _mm256_loadu_pd(y + i);
+			__m256d pointZ = _mm256_loadu_pd(z + i);
+
+			__m256d result = _mm256_setzero_pd();
+			double amplitude = 1.0;
+			for (int octave = 0; octave < octaves; ++octave)
+			{
+				result = _mm256_add_pd(result, _mm256_mul_pd(noise3D_avx2(permutation, pointX, pointY, pointZ), _mm256_set1_pd(amplitude)));
+
+				pointX = _mm256_add_pd(pointX, pointX);
+				pointY = _mm256_add_pd(pointY, pointY);
+				pointZ = _mm256_add_pd(pointZ, pointZ);
+				amplitude *= 0.5;
+			}
+
+			// the clamp is exact, result * 0.5 + 0.5 crosses 0 and 1 exactly at -1 and 1
+			result = _mm256_add_pd(_mm256_mul_pd(result, _mm256_set1_pd(0.5)), _mm256_set1_pd(0.5));
+			result = _mm256_min_pd(_mm256_max_pd(result, _mm256_setzero_pd()), _mm256_set1_pd(1.0));
+
+			_mm256_storeu_pd(values + i, result);
+		}
+	}
+#endif
+
+	WorldNoise::WorldNoise(const uint32_t seed)
+	{
+		m_seed = seed;
+		m_kernel = get_best_kernel();
+
+		const auto perlin = siv::PerlinNoise(seed);
+		const auto& permutation = perlin.serialize();
+		for (size_t i = 0; i < m_permutation.size(); ++i)
+		{
+			m_permutation[i] = permutation[i & 255];
+		}
+	}
+
+	void WorldNoise::set_kernel(const NoiseKernel kernel)
+	{
+		LOG_ASSERT(is_supported(kernel), "Noise kernel is not supported on this cpu");
+
+		m_kernel = kernel;
+	}
+
+	double WorldNoise::octave3D_01(double x, double y, double z, const int octaves) const
+	{
+		double result = 0.0;
+		double amplitude = 1.0;
+		for (int octave = 0; octave < octaves; ++octave)
+		{
+			result += noise3D(m_permutation.data(), x, y, z) * amplitude;
+
+			x *= 2;
+			y *= 2;
+			z *= 2;
+			amplitude *= 0.5;
+		}
+
+		return remap_clamp_01(result);
+	}
+
+	NoiseBounds WorldNoise::octave3D_01_bounds(glm::dvec3 min, glm::dvec3 max, const int octaves) const
+	{
+		double lower = 0.0;
+		double upper = 0.0;
+		double amplitude = 1.0;
+		for (int octave = 0; octave < octaves; ++octave)
+		{
+			const auto bounds = noise3D_bounds(m_permutation.data(), min, max);
+			lower += bounds.Min * amplitude;
+			upper += bounds.Max * amplitude;
+
+			min *= 2;
+			max *= 2;
+			amplitude *= 0.5;
+		}
+
+		// margin for the rounding of the sampled sums, which add in a different order
+		constexpr double ROUNDING_MARGIN = 1e-9;
+
+		return { remap_clamp_01(lower - ROUNDING_MARGIN), remap_clamp_01(upper + ROUNDING_MARGIN) };
+	}
+
+	void WorldNoise::octave3D_01(const double* x, const double* y, const double* z, double* values, const int octaves, const NoiseKernel kernel) const
+	{
+		switch (kernel)
+		{
+#if defined(MOXEL_ARCH_X86)
+			case NoiseKernel::AVX2: octave3D_01_avx2(m_permutation.data(), x, y, z, values, octaves); break;
+#endif
+			default:
+			{
+				for (int i = 0; i < BATCH_SIZE; ++i)
+				{
+					values[i] = octave3D_01(x[i], y[i], z[i], octaves);
+				}
+				break;
+			}
+		}
+	}
+
+	NoiseKernel WorldNoise::get_best_kernel()
+	{
+		if (CpuFeatures::has_avx2())
+			return NoiseKernel::AVX2;
+
+		return NoiseKernel::SCALAR;
+	}
+
+	bool WorldNoise::is_supported(const NoiseKernel kernel)
+	{
+		switch (kernel)
+		{
+			case NoiseKernel::AVX2: return CpuFeatures::has_avx2();
+			default: return true;
+		}
+	}
+
+	const char* WorldNoise::get_kernel_name(const NoiseKernel kernel)
+	{
+		switch (kernel)
+		{
+			case NoiseKernel::AVX2: return "avx2";
+			default: return "scalar";
+		}
+	}
+}
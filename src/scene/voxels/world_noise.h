@@ -0,0 +1,57 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include <glm/glm.hpp>
+
+namespace Moxel
+{
+	enum class NoiseKernel
+	{
+		SCALAR,
+		AVX2
+	};
+
+	struct NoiseBounds
+	{
+		double Min = 0.0;
+		double Max = 1.0;
+	};
+
+	// 3d gradient noise shared by every chunk of a world. the permutation table is taken from
+	// siv::PerlinNoise once per seed and the kernels reproduce its octave3D_01, so terrain
+	// matches the per-chunk PerlinNoise it replaces
+	class WorldNoise
+	{
+	public:
+		static constexpr int BATCH_SIZE = 8;
+
+		WorldNoise(uint32_t seed);
+
+		// fractal noise remapped to [0, 1], every octave doubles the frequency and halves the amplitude
+		double octave3D_01(double x, double y, double z, int octaves) const;
+
+		// conservative range of octave3D_01 over every point of the box, from interval arithmetic
+		// on each lattice cell the box touches instead of sampling
+		NoiseBounds octave3D_01_bounds(glm::dvec3 min, glm::dvec3 max, int octaves) const;
+
+		// BATCH_SIZE points per call
+		void octave3D_01(const double* x, const double* y, const double* z, double* values, const int octaves) const { octave3D_01(x, y, z, values, octaves, m_kernel); }
+		void octave3D_01(const double* x, const double* y, const double* z, double* values, int octaves, NoiseKernel kernel) const;
+
+		uint32_t get_seed() const { return m_seed; }
+
+		NoiseKernel get_kernel() const { return m_kernel; }
+		void set_kernel(NoiseKernel kernel);
+
+		static NoiseKernel get_best_kernel();
+		static bool is_supported(NoiseKernel kernel);
+		static const char* get_kernel_name(NoiseKernel kernel);
+	private:
+		uint32_t m_seed = 0;
+		NoiseKernel m_kernel = NoiseKernel::SCALAR;
+
+		std::array<int32_t, 512> m_permutation = {}; // repeated twice, so index + 1 never wraps
+	};
+}